@@ -0,0 +1,158 @@
+#include <BitKernelsCore.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GOL_X86 1
+#if !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+#endif
+
+namespace
+{
+    struct ScalarOps
+    {
+        using Vector = Word;
+        static constexpr int Width = 1;
+
+        static Vector Load(const Word* p) { return *p; }
+        static void Store(Word* p, Vector v) { *p = v; }
+        static Vector West(const Word* p) { return (p[0] << 1) | (p[-1] >> 63); }
+        static Vector East(const Word* p) { return (p[0] >> 1) | (p[1] << 63); }
+        static Vector Zero() { return 0; }
+        static Vector And(Vector a, Vector b) { return a & b; }
+        static Vector Or(Vector a, Vector b) { return a | b; }
+        static Vector Xor(Vector a, Vector b) { return a ^ b; }
+        static Vector AndNot(Vector a, Vector b) { return ~a & b; }
+        static Vector Not(Vector a) { return ~a; }
+    };
+
+    template<std::size_t RuleIndex>
+    struct ScalarKernel
+    {
+        static void Step(const Word* above, const Word* row, const Word* below, Word* nextRow, int firstWord, int lastWord, const Rule&)
+        {
+            constexpr auto rule = BuiltinRules[RuleIndex];
+            BitKernels::StepRowVectors<ScalarOps, rule.birth, rule.survival>(above, row, below, nextRow, firstWord, lastWord);
+        }
+    };
+
+    constexpr auto ScalarKernels = BitKernels::MakeRowKernels<ScalarKernel>(std::make_index_sequence<BuiltinRules.size()>());
+
+#if defined(GOL_X86)
+    void CpuId(unsigned leaf, unsigned subLeaf, unsigned regs[4])
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subLeaf));
+        for (int i = 0; i < 4; i++)
+            regs[i] = static_cast<unsigned>(info[i]);
+#else
+        __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    unsigned long long XGetBv()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+    }
+#endif
+}
+
+namespace BitKernels
+{
+    const RowKernel* ScalarRowKernels()
+    {
+        return ScalarKernels.data();
+    }
+
+    void StepRowAnyRule(const Word* above, const Word* row, const Word* below, Word* nextRow, int firstWord, int lastWord, const Rule& rule)
+    {
+        for (int i = firstWord; i < lastWord; i++)
+        {
+            Word count[4];
+            CountNeighbors<ScalarOps>(above + i, row + i, below + i, count);
+
+            auto born = Word(0);
+            auto survives = Word(0);
+            for (int n = 0; n <= 8; n++)
+            {
+                auto equals = ~Word(0);
+                for (int bit = 0; bit < 4; bit++)
+                    equals &= (n >> bit) & 1 ? count[bit] : ~count[bit];
+                if ((rule.birth >> n) & 1)
+                    born |= equals;
+                if ((rule.survival >> n) & 1)
+                    survives |= equals;
+            }
+            nextRow[i] = (~row[i] & born) | (row[i] & survives);
+        }
+    }
+
+    Isa DetectIsa()
+    {
+#if defined(GOL_X86)
+        unsigned regs[4];
+        CpuId(0, 0, regs);
+        if (regs[0] < 7)
+            return Isa::Scalar;
+
+        CpuId(1, 0, regs);
+        auto osXSave = (regs[2] >> 27) & 1;
+        if (!osXSave)
+            return Isa::Scalar;
+
+        auto xcr0 = XGetBv();
+        auto osAvx = (xcr0 & 0x6) == 0x6;       // XMM and YMM state
+        auto osAvx512 = (xcr0 & 0xE6) == 0xE6;  // plus opmask and ZMM state
+
+        CpuId(7, 0, regs);
+        auto hasAvx2 = (regs[1] >> 5) & 1;
+        auto hasAvx512F = (regs[1] >> 16) & 1;
+
+        if (hasAvx512F && osAvx512)
+            return Isa::AVX512;
+        if (hasAvx2 && osAvx)
+            return Isa::AVX2;
+#endif
+        return Isa::Scalar;
+    }
+
+    const char* IsaName(Isa isa)
+    {
+        switch (isa)
+        {
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::AVX512:
+            return "AVX-512";
+        default:
+            return "scalar";
+        }
+    }
+
+    RowKernel SelectRowKernel(Isa isa, const Rule& rule)
+    {
+        for (std::size_t i = 0; i < BuiltinRules.size(); i++)
+        {
+            if (BuiltinRules[i] != rule)
+                continue;
+
+            switch (isa)
+            {
+            case Isa::AVX2:
+                return AVX2RowKernels()[i];
+            case Isa::AVX512:
+                return AVX512RowKernels()[i];
+            default:
+                return ScalarRowKernels()[i];
+            }
+        }
+        return StepRowAnyRule;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <Rule.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using Word = std::uint64_t;
+
+namespace BitKernels
+{
+    enum class Isa
+    {
+        Scalar,
+        AVX2,
+        AVX512,
+    };
+
+    // Computes words [firstWord, lastWord) of the next generation of `row`.
+    // The words at firstWord - 1 and lastWord of all three input rows must be readable.
+    // Kernels compiled for one of BuiltinRules ignore the rule argument.
+    using RowKernel = void(*)(const Word* above, const Word* row, const Word* below, Word* nextRow, int firstWord, int lastWord, const Rule& rule);
+
+    Isa DetectIsa();
+    const char* IsaName(Isa isa);
+    // Picks the kernel specialized for the rule when it is one of BuiltinRules,
+    // otherwise StepRowAnyRule, which reads the rule masks at run time.
+    RowKernel SelectRowKernel(Isa isa, const Rule& rule);
+
+    // One kernel per entry of BuiltinRules, in the same order.
+    const RowKernel* ScalarRowKernels();
+    const RowKernel* AVX2RowKernels();
+    const RowKernel* AVX512RowKernels();
+
+    void StepRowAnyRule(const Word* above, const Word* row, const Word* below, Word* nextRow, int firstWord, int lastWord, const Rule& rule);
+
+    // 65536 entries mapping a 4x4 block, bit (r * 4 + c), to the next generation of its 2x2 centre,
+    // bits (1, 1), (1, 2), (2, 1), (2, 2) from low to high. Built on first use for each rule.
+    const std::uint8_t* LookupTable(const Rule& rule);
+
+    // Computes two rows at once through a lookup table, same word range contract as RowKernel.
+    void StepRowPairLookup(const Word* above, const Word* row, const Word* rowBelow, const Word* below,
+        Word* nextRow, Word* nextRowBelow, int firstWord, int lastWord, const std::uint8_t* lookupTable);
+
+    inline int PopCount(Word word)
+    {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(word));
+#else
+        return __builtin_popcountll(word);
+#endif
+    }
+
+    inline int LowestBitIndex(Word word)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+}
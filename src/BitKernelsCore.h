@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <BitKernels.h>
+
+// Carry-save adder network shared by all kernels. `Ops` wraps one register type
+// (a single Word, or a 256/512 bit vector of Words) and provides:
+//   Vector, Width (Words per Vector), Load, Store, West, East, Zero, And, Or, Xor, AndNot, Not.
+// West/East return the row shifted by one cell, carrying bits across Word boundaries.
+// Each ISA instantiates this only with its own Ops type, inside its own translation unit.
+namespace BitKernels
+{
+    template<class Ops>
+    inline void Add2(typename Ops::Vector a, typename Ops::Vector b,
+        typename Ops::Vector& sum, typename Ops::Vector& carry)
+    {
+        sum = Ops::Xor(a, b);
+        carry = Ops::And(a, b);
+    }
+
+    template<class Ops>
+    inline void Add3(typename Ops::Vector a, typename Ops::Vector b, typename Ops::Vector c,
+        typename Ops::Vector& sum, typename Ops::Vector& carry)
+    {
+        auto ab = Ops::Xor(a, b);
+        sum = Ops::Xor(ab, c);
+        carry = Ops::Or(Ops::And(a, b), Ops::And(ab, c));
+    }
+
+    // Lanes whose neighbour count, given as bits count[0..3], equals N.
+    template<class Ops, int N>
+    inline typename Ops::Vector CountEquals(const typename Ops::Vector count[4])
+    {
+        auto bit = [&count](int i) { return (N >> i) & 1 ? count[i] : Ops::Not(count[i]); };
+        return Ops::And(Ops::And(bit(0), bit(1)), Ops::And(bit(2), bit(3)));
+    }
+
+    // Lanes whose neighbour count is one of the counts set in Mask.
+    template<class Ops, std::uint16_t Mask, std::size_t... N>
+    inline typename Ops::Vector CountInMask(const typename Ops::Vector count[4], std::index_sequence<N...>)
+    {
+        auto result = Ops::Zero();
+        ((result = (Mask >> N) & 1 ? Ops::Or(result, CountEquals<Ops, N>(count)) : result), ...);
+        return result;
+    }
+
+    template<class Ops>
+    inline void CountNeighbors(const Word* above, const Word* row, const Word* below, typename Ops::Vector count[4])
+    {
+        using Vector = typename Ops::Vector;
+
+        Vector aboveOnes, aboveTwos;
+        Add3<Ops>(Ops::West(above), Ops::Load(above), Ops::East(above), aboveOnes, aboveTwos);
+
+        Vector belowOnes, belowTwos;
+        Add3<Ops>(Ops::West(below), Ops::Load(below), Ops::East(below), belowOnes, belowTwos);
+
+        Vector rowOnes, rowTwos;
+        Add2<Ops>(Ops::West(row), Ops::East(row), rowOnes, rowTwos);
+
+        Vector onesCarry, twosSum, twosCarry, foursCarry;
+        Add3<Ops>(aboveOnes, belowOnes, rowOnes, count[0], onesCarry);
+        Add3<Ops>(aboveTwos, belowTwos, rowTwos, twosSum, twosCarry);
+        Add2<Ops>(twosSum, onesCarry, count[1], foursCarry);
+        Add2<Ops>(twosCarry, foursCarry, count[2], count[3]);
+    }
+
+    template<class Ops, std::uint16_t Birth, std::uint16_t Survival>
+    inline typename Ops::Vector NextGeneration(const Word* above, const Word* row, const Word* below)
+    {
+        using Vector = typename Ops::Vector;
+
+        if constexpr (Birth == ConwayLife.birth && Survival == ConwayLife.survival)
+        {
+            Vector aboveOnes, aboveTwos;
+            Add3<Ops>(Ops::West(above), Ops::Load(above), Ops::East(above), aboveOnes, aboveTwos);
+
+            Vector belowOnes, belowTwos;
+            Add3<Ops>(Ops::West(below), Ops::Load(below), Ops::East(below), belowOnes, belowTwos);
+
+            Vector rowOnes, rowTwos;
+            Add2<Ops>(Ops::West(row), Ops::East(row), rowOnes, rowTwos);
+
+            Vector ones, onesCarry;
+            Add3<Ops>(aboveOnes, belowOnes, rowOnes, ones, onesCarry);
+
+            // The cell lives next generation iff exactly one of the four "two" bits is set
+            // (2 or 3 neighbours), and either the ones bit is set (3) or the cell is alive (2).
+            Vector twos, twosCarry;
+            Add3<Ops>(aboveTwos, belowTwos, rowTwos, twos, twosCarry);
+            auto exactlyOneTwo = Ops::AndNot(twosCarry, Ops::Xor(twos, onesCarry));
+
+            return Ops::And(exactlyOneTwo, Ops::Or(ones, Ops::Load(row)));
+        }
+        else
+        {
+            Vector count[4];
+            CountNeighbors<Ops>(above, row, below, count);
+
+            auto alive = Ops::Load(row);
+            auto born = CountInMask<Ops, Birth>(count, std::make_index_sequence<9>());
+            auto survives = CountInMask<Ops, Survival>(count, std::make_index_sequence<9>());
+            return Ops::Or(Ops::AndNot(alive, born), Ops::And(alive, survives));
+        }
+    }
+
+    // Steps as many whole vectors as fit in [firstWord, lastWord) and returns the first word not computed.
+    template<class Ops, std::uint16_t Birth, std::uint16_t Survival>
+    inline int StepRowVectors(const Word* above, const Word* row, const Word* below, Word* nextRow, int firstWord, int lastWord)
+    {
+        auto i = firstWord;
+        for (; i + Ops::Width <= lastWord; i += Ops::Width)
+        {
+            Ops::Store(nextRow + i, NextGeneration<Ops, Birth, Survival>(above + i, row + i, below + i));
+        }
+        return i;
+    }
+
+    // Table of Kernel<0> .. Kernel<N - 1>, one instantiation per entry of BuiltinRules.
+    template<template<std::size_t> class Kernel, std::size_t... RuleIndex>
+    constexpr std::array<RowKernel, sizeof...(RuleIndex)> MakeRowKernels(std::index_sequence<RuleIndex...>)
+    {
+        return { { &Kernel<RuleIndex>::Step... } };
+    }
+}
@@ -0,0 +1,54 @@
+#include <BitKernelsCore.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx2Ops
+    {
+        using Vector = __m256i;
+        static constexpr int Width = 4;
+
+        static Vector Load(const Word* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        static void Store(Word* p, Vector v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+        static Vector West(const Word* p) { return _mm256_or_si256(_mm256_slli_epi64(Load(p), 1), _mm256_srli_epi64(Load(p - 1), 63)); }
+        static Vector East(const Word* p) { return _mm256_or_si256(_mm256_srli_epi64(Load(p), 1), _mm256_slli_epi64(Load(p + 1), 63)); }
+        static Vector Zero() { return _mm256_setzero_si256(); }
+        static Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+        static Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+        static Vector Xor(Vector a, Vector b) { return _mm256_xor_si256(a, b); }
+        static Vector AndNot(Vector a, Vector b) { return _mm256_andnot_si256(a, b); }
+        static Vector Not(Vector a) { return _mm256_xor_si256(a, _mm256_set1_epi64x(-1)); }
+    };
+
+    template<std::size_t RuleIndex>
+    struct Avx2Kernel
+    {
+        static void Step(const Word* above, const Word* row, const Word* below, Word* nextRow, int firstWord, int lastWord, const Rule& rule)
+        {
+            constexpr auto builtinRule = BuiltinRules[RuleIndex];
+            auto tail = BitKernels::StepRowVectors<Avx2Ops, builtinRule.birth, builtinRule.survival>(above, row, below, nextRow, firstWord, lastWord);
+            BitKernels::ScalarRowKernels()[RuleIndex](above, row, below, nextRow, tail, lastWord, rule);
+        }
+    };
+
+    constexpr auto Avx2Kernels = BitKernels::MakeRowKernels<Avx2Kernel>(std::make_index_sequence<BuiltinRules.size()>());
+}
+
+namespace BitKernels
+{
+    const RowKernel* AVX2RowKernels()
+    {
+        return Avx2Kernels.data();
+    }
+}
+#else
+namespace BitKernels
+{
+    const RowKernel* AVX2RowKernels()
+    {
+        return ScalarRowKernels();
+    }
+}
+#endif
@@ -0,0 +1,54 @@
+#include <BitKernelsCore.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+
+namespace
+{
+    struct Avx512Ops
+    {
+        using Vector = __m512i;
+        static constexpr int Width = 8;
+
+        static Vector Load(const Word* p) { return _mm512_loadu_si512(p); }
+        static void Store(Word* p, Vector v) { _mm512_storeu_si512(p, v); }
+        static Vector West(const Word* p) { return _mm512_or_si512(_mm512_slli_epi64(Load(p), 1), _mm512_srli_epi64(Load(p - 1), 63)); }
+        static Vector East(const Word* p) { return _mm512_or_si512(_mm512_srli_epi64(Load(p), 1), _mm512_slli_epi64(Load(p + 1), 63)); }
+        static Vector Zero() { return _mm512_setzero_si512(); }
+        static Vector And(Vector a, Vector b) { return _mm512_and_si512(a, b); }
+        static Vector Or(Vector a, Vector b) { return _mm512_or_si512(a, b); }
+        static Vector Xor(Vector a, Vector b) { return _mm512_xor_si512(a, b); }
+        static Vector AndNot(Vector a, Vector b) { return _mm512_andnot_si512(a, b); }
+        static Vector Not(Vector a) { return _mm512_xor_si512(a, _mm512_set1_epi64(-1)); }
+    };
+
+    template<std::size_t RuleIndex>
+    struct Avx512Kernel
+    {
+        static void Step(const Word* above, const Word* row, const Word* below, Word* nextRow, int firstWord, int lastWord, const Rule& rule)
+        {
+            constexpr auto builtinRule = BuiltinRules[RuleIndex];
+            auto tail = BitKernels::StepRowVectors<Avx512Ops, builtinRule.birth, builtinRule.survival>(above, row, below, nextRow, firstWord, lastWord);
+            BitKernels::ScalarRowKernels()[RuleIndex](above, row, below, nextRow, tail, lastWord, rule);
+        }
+    };
+
+    constexpr auto Avx512Kernels = BitKernels::MakeRowKernels<Avx512Kernel>(std::make_index_sequence<BuiltinRules.size()>());
+}
+
+namespace BitKernels
+{
+    const RowKernel* AVX512RowKernels()
+    {
+        return Avx512Kernels.data();
+    }
+}
+#else
+namespace BitKernels
+{
+    const RowKernel* AVX512RowKernels()
+    {
+        return ScalarRowKernels();
+    }
+}
+#endif
@@ -0,0 +1,88 @@
+#include <BitKernels.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    std::vector<std::uint8_t> BuildLookupTable(const Rule& rule)
+    {
+        auto table = std::vector<std::uint8_t>(1 << 16);
+        for (unsigned block = 0; block < table.size(); block++)
+        {
+            auto next = [block, &rule](int r, int c)
+            {
+                auto nrAliveNeighbors = 0u;
+                for (int i = r - 1; i <= r + 1; i++)
+                {
+                    for (int j = c - 1; j <= c + 1; j++)
+                    {
+                        if (i != r || j != c)
+                            nrAliveNeighbors += (block >> (i * 4 + j)) & 1;
+                    }
+                }
+                auto alive = (block >> (r * 4 + c)) & 1;
+                return rule.IsAliveNextGeneration(alive, nrAliveNeighbors) ? 1u : 0u;
+            };
+            table[block] = static_cast<std::uint8_t>(next(1, 1) | next(1, 2) << 1 | next(2, 1) << 2 | next(2, 2) << 3);
+        }
+        return table;
+    }
+
+    // Bit k of the result is the cell at column 64 * i + k - 1.
+    inline Word FromColumnBefore(const Word* row, int i)
+    {
+        return (row[i] << 1) | (row[i - 1] >> 63);
+    }
+}
+
+namespace BitKernels
+{
+    const std::uint8_t* LookupTable(const Rule& rule)
+    {
+        static std::mutex tablesMutex;
+        static std::map<std::pair<std::uint16_t, std::uint16_t>, std::vector<std::uint8_t>> tables;
+
+        std::lock_guard<std::mutex> lock(tablesMutex);
+        auto& table = tables[{ rule.birth, rule.survival }];
+        if (table.empty())
+            table = BuildLookupTable(rule);
+        return table.data();
+    }
+
+    void StepRowPairLookup(const Word* above, const Word* row, const Word* rowBelow, const Word* below,
+        Word* nextRow, Word* nextRowBelow, int firstWord, int lastWord, const std::uint8_t* table)
+    {
+        const Word* rows[4] = { above, row, rowBelow, below };
+
+        for (int i = firstWord; i < lastWord; i++)
+        {
+            // For the output columns (c, c + 1) every row contributes the 4 cells c - 1 .. c + 2.
+            Word windows[4];
+            Word carries[4];
+            for (int r = 0; r < 4; r++)
+            {
+                windows[r] = FromColumnBefore(rows[r], i);
+                carries[r] = FromColumnBefore(rows[r], i + 1) & 3;
+            }
+
+            auto next = Word(0);
+            auto nextBelow = Word(0);
+            for (int bit = 0; bit < 64; bit += 2)
+            {
+                auto block = 0u;
+                for (int r = 0; r < 4; r++)
+                {
+                    auto window = bit < 62 ? windows[r] >> bit : (windows[r] >> 62) | (carries[r] << 2);
+                    block |= static_cast<unsigned>(window & 0xF) << (r * 4);
+                }
+                auto result = table[block];
+                next |= static_cast<Word>(result & 3) << bit;
+                nextBelow |= static_cast<Word>(result >> 2) << bit;
+            }
+            nextRow[i] = next;
+            nextRowBelow[i] = nextBelow;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// What the engines see beyond the edges of the board.
+enum class Boundary
+{
+    Dead,       // everything outside is dead
+    Torus,      // the opposite edge wraps around
+    Mirror,     // the cells just outside repeat the edge cells
+};
+
+// Maps a row or column index at most one step outside [0, size) onto the board, or returns -1
+// when that cell is dead.
+inline int WrapCoordinate(int coord, int size, Boundary boundary)
+{
+    if (coord >= 0 && coord < size)
+        return coord;
+
+    switch (boundary)
+    {
+    case Boundary::Torus:
+        return coord < 0 ? coord + size : coord - size;
+    case Boundary::Mirror:
+        return coord < 0 ? 0 : size - 1;
+    default:
+        return -1;
+    }
+}
+
+inline const char* BoundaryName(Boundary boundary)
+{
+    switch (boundary)
+    {
+    case Boundary::Torus:
+        return "torus";
+    case Boundary::Mirror:
+        return "mirror";
+    default:
+        return "dead";
+    }
+}
@@ -0,0 +1,305 @@
+#include <Checkpoint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+#include <Compression.h>
+#include <FileWriter.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GOL_POSIX 1
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr char CheckpointMagic[8] = { 'G', 'O', 'L', 'C', 'K', 'P', 'T', '\0' };
+    constexpr std::uint32_t CheckpointVersion = 1;
+    // 256 rows of a 40000 wide board are 1.25 MiB, enough to amortize a task and to keep the pool busy
+    constexpr int BandRows = 256;
+
+    // All fields in the machine's byte order, like the packed rows.
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t headerBytes;
+        std::int32_t width;
+        std::int32_t height;
+        std::uint16_t birth;
+        std::uint16_t survival;
+        std::uint32_t boundary;
+        std::uint64_t generation;
+        std::int32_t bandRows;
+        std::uint32_t nrBands;
+    };
+    static_assert(sizeof(FileHeader) == 48, "the header layout is part of the format");
+
+    struct BandEntry
+    {
+        std::uint64_t compressedBytes;
+        std::uint64_t checksum;     // of the uncompressed words
+    };
+
+    int NrBands(int height, int bandRows)
+    {
+        return static_cast<int>((static_cast<std::int64_t>(height) + bandRows - 1) / bandRows);
+    }
+
+    template <typename F>
+    void ForEachBand(int nrBands, ThreadPool* pool, F&& f)
+    {
+        if (pool)
+        {
+            pool->ParallelFor(nrBands, f);
+            return;
+        }
+        for (int band = 0; band < nrBands; band++)
+            f(band);
+    }
+
+    bool WriteBands(std::ostream& out, const GameOfLife_BitPacked& gol, std::uint64_t generation, ThreadPool* pool)
+    {
+        auto wordsPerRow = static_cast<std::size_t>(gol.WordsPerRow());
+        // never more than the board, readers reject larger bands
+        auto bandRows = std::min(BandRows, gol.Height());
+        auto nrBands = NrBands(gol.Height(), bandRows);
+        auto entries = std::vector<BandEntry>(nrBands);
+        auto payloads = std::vector<std::vector<std::uint8_t>>(nrBands);
+        ForEachBand(nrBands, pool, [&](int band)
+        {
+            auto startRow = band * bandRows;
+            auto endRow = std::min(startRow + bandRows, gol.Height());
+            auto words = std::vector<Word>((endRow - startRow) * wordsPerRow);
+            for (int row = startRow; row < endRow; row++)
+                std::copy_n(gol.GetRow(row), wordsPerRow, words.begin() + (row - startRow) * wordsPerRow);
+
+            payloads[band] = Compression::EncodeWords(words.data(), words.size());
+            entries[band] = BandEntry{ payloads[band].size(), Compression::Checksum(words.data(), words.size()) };
+        });
+
+        auto header = FileHeader{};
+        std::memcpy(header.magic, CheckpointMagic, sizeof(CheckpointMagic));
+        header.version = CheckpointVersion;
+        header.headerBytes = sizeof(FileHeader);
+        header.width = gol.Width();
+        header.height = gol.Height();
+        header.birth = gol.GetRule().birth;
+        header.survival = gol.GetRule().survival;
+        header.boundary = static_cast<std::uint32_t>(gol.GetBoundary());
+        header.generation = generation;
+        header.bandRows = bandRows;
+        header.nrBands = static_cast<std::uint32_t>(nrBands);
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(BandEntry)));
+        for (const auto& payload : payloads)
+            out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        return static_cast<bool>(out.flush());
+    }
+
+    bool ReadBands(std::istream& in, const CheckpointHeader& header, GameOfLife_BitPacked& gol, ThreadPool* pool)
+    {
+        if (gol.Width() != header.width || gol.Height() != header.height)
+            return false;
+
+        auto wordsPerRow = static_cast<std::size_t>(gol.WordsPerRow());
+        auto nrBands = NrBands(header.height, header.bandRows);
+        auto entries = std::vector<BandEntry>(nrBands);
+        if (!in.read(reinterpret_cast<char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(BandEntry))))
+            return false;
+
+        auto payloads = std::vector<std::vector<std::uint8_t>>(nrBands);
+        for (int band = 0; band < nrBands; band++)
+        {
+            // nothing compresses to more than twice its size, larger entries are corrupt
+            auto bandRows = std::min(header.bandRows, header.height - band * header.bandRows);
+            auto maxBytes = 2 * static_cast<std::uint64_t>(bandRows) * wordsPerRow * sizeof(Word) + 64;
+            if (entries[band].compressedBytes > maxBytes)
+                return false;
+            payloads[band].resize(static_cast<std::size_t>(entries[band].compressedBytes));
+            if (!in.read(reinterpret_cast<char*>(payloads[band].data()), static_cast<std::streamsize>(payloads[band].size())))
+                return false;
+        }
+
+        gol.SetRule(header.rule);
+        gol.SetBoundary(header.boundary);
+
+        std::atomic<bool> ok{ true };
+        ForEachBand(nrBands, pool, [&](int band)
+        {
+            auto startRow = band * header.bandRows;
+            auto endRow = std::min(startRow + header.bandRows, header.height);
+            auto words = std::vector<Word>((endRow - startRow) * wordsPerRow);
+            if (!Compression::DecodeWords(payloads[band].data(), payloads[band].size(), words.data(), words.size()) ||
+                Compression::Checksum(words.data(), words.size()) != entries[band].checksum)
+            {
+                ok = false;
+                return;
+            }
+            for (int row = startRow; row < endRow; row++)
+                gol.SetRow(row, words.data() + (row - startRow) * wordsPerRow);
+        });
+        return ok;
+    }
+}
+
+bool WriteCheckpoint(std::ostream& out, const GameOfLife_BitPacked& gol, std::uint64_t generation)
+{
+    return WriteBands(out, gol, generation, nullptr);
+}
+
+bool WriteCheckpoint(std::ostream& out, const GameOfLife_BitPacked& gol, std::uint64_t generation, ThreadPool& pool)
+{
+    return WriteBands(out, gol, generation, &pool);
+}
+
+bool ReadCheckpointHeader(std::istream& in, CheckpointHeader& header)
+{
+    auto fileHeader = FileHeader{};
+    if (!in.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader)))
+        return false;
+
+    if (std::memcmp(fileHeader.magic, CheckpointMagic, sizeof(CheckpointMagic)) != 0 || fileHeader.version != CheckpointVersion ||
+        fileHeader.headerBytes != sizeof(FileHeader) || fileHeader.width <= 0 || fileHeader.height <= 0 || fileHeader.bandRows <= 0 || fileHeader.bandRows > fileHeader.height ||
+        fileHeader.boundary > static_cast<std::uint32_t>(Boundary::Mirror) || (fileHeader.birth & 1) ||
+        fileHeader.nrBands != static_cast<std::uint32_t>(NrBands(fileHeader.height, fileHeader.bandRows)))
+        return false;
+
+    header.width = fileHeader.width;
+    header.height = fileHeader.height;
+    header.rule = Rule{ fileHeader.birth, fileHeader.survival };
+    header.boundary = static_cast<Boundary>(fileHeader.boundary);
+    header.generation = fileHeader.generation;
+    header.bandRows = fileHeader.bandRows;
+    return true;
+}
+
+bool ReadCheckpointBoard(std::istream& in, const CheckpointHeader& header, GameOfLife_BitPacked& gol)
+{
+    return ReadBands(in, header, gol, nullptr);
+}
+
+bool ReadCheckpointBoard(std::istream& in, const CheckpointHeader& header, GameOfLife_BitPacked& gol, ThreadPool& pool)
+{
+    return ReadBands(in, header, gol, &pool);
+}
+
+BackgroundCheckpoint::~BackgroundCheckpoint()
+{
+    Wait();
+}
+
+#if GOL_POSIX
+namespace
+{
+    // waitpid that is not cut short by signals, which would leave the child a zombie
+    pid_t WaitForChild(long long pid, int& status, int options)
+    {
+        auto waited = pid_t(0);
+        do
+        {
+            waited = ::waitpid(static_cast<pid_t>(pid), &status, options);
+        } while (waited < 0 && errno == EINTR);
+        return waited;
+    }
+}
+
+bool BackgroundCheckpoint::IsSupported()
+{
+    return true;
+}
+
+bool BackgroundCheckpoint::Start(const GameOfLife_BitPacked& gol, std::uint64_t generation, const std::string& path)
+{
+    if (IsRunning() || gol.IsMapped())
+        return false;
+
+    auto start = std::chrono::steady_clock::now();
+    auto pid = ::fork();
+    if (pid == 0)
+    {
+        // only the forking thread exists here, so no pool; _exit leaves the parent's streams and
+        // atexit handlers alone
+        auto tempPath = path + ".tmp";
+        auto ok = false;
+        {
+            FileWriterStream out(tempPath);
+            ok = out && WriteCheckpoint(out, gol, generation);
+            ok = out.Close() && ok;
+        }
+        ok = ok && std::rename(tempPath.c_str(), path.c_str()) == 0;
+        ::_exit(ok ? 0 : 1);
+    }
+    m_forkMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    if (pid < 0)
+        return false;
+
+    // a failure that IsRunning collected is kept for the next Wait
+    m_pid = pid;
+    m_earlierFailed = m_earlierFailed || (m_hasResult && !m_succeeded);
+    m_hasResult = false;
+    return true;
+}
+
+bool BackgroundCheckpoint::IsRunning()
+{
+    if (m_pid < 0)
+        return false;
+
+    auto status = 0;
+    auto waited = WaitForChild(m_pid, status, WNOHANG);
+    if (waited == 0)
+        return true;
+
+    m_pid = -1;
+    m_hasResult = true;
+    m_succeeded = waited > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    return false;
+}
+
+bool BackgroundCheckpoint::Wait()
+{
+    if (m_pid >= 0)
+    {
+        auto status = 0;
+        auto waited = WaitForChild(m_pid, status, 0);
+        m_pid = -1;
+        m_hasResult = true;
+        m_succeeded = waited > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    auto succeeded = m_hasResult && m_succeeded && !m_earlierFailed;
+    m_hasResult = false;
+    m_earlierFailed = false;
+    return succeeded;
+}
+#else
+bool BackgroundCheckpoint::IsSupported()
+{
+    return false;
+}
+
+bool BackgroundCheckpoint::Start(const GameOfLife_BitPacked&, std::uint64_t, const std::string&)
+{
+    return false;
+}
+
+bool BackgroundCheckpoint::IsRunning()
+{
+    return false;
+}
+
+bool BackgroundCheckpoint::Wait()
+{
+    return false;
+}
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <ImplGameOfLife_BitPacked.h>
+#include <ThreadPool.h>
+
+// Versioned binary snapshot of a bit-packed run: a fixed header with the generation, rule,
+// dimensions and boundary, a table with the compressed size and checksum of every row band, and
+// the bands compressed with Compression::EncodeWords. Bands are compressed and decompressed
+// independently, on the pool's workers when one is given.
+struct CheckpointHeader
+{
+    int width = 0;
+    int height = 0;
+    Rule rule = ConwayLife;
+    Boundary boundary = Boundary::Dead;
+    std::uint64_t generation = 0;
+    int bandRows = 0;
+};
+
+bool WriteCheckpoint(std::ostream& out, const GameOfLife_BitPacked& gol, std::uint64_t generation);
+bool WriteCheckpoint(std::ostream& out, const GameOfLife_BitPacked& gol, std::uint64_t generation, ThreadPool& pool);
+
+// Reads the header, so that a board of the right size can be created before ReadCheckpointBoard.
+bool ReadCheckpointHeader(std::istream& in, CheckpointHeader& header);
+// Restores the board, rule and boundary that follow header. False, with the board in an
+// unspecified state, when the checkpoint is corrupt or gol has other dimensions.
+bool ReadCheckpointBoard(std::istream& in, const CheckpointHeader& header, GameOfLife_BitPacked& gol);
+bool ReadCheckpointBoard(std::istream& in, const CheckpointHeader& header, GameOfLife_BitPacked& gol, ThreadPool& pool);
+
+// Checkpoints without pausing the run, like Redis' BGSAVE: Start forks at a generation boundary
+// and the child writes its copy-on-write view of the board to path while the parent keeps
+// stepping, so the stall is the page table copy of fork rather than the I/O. The file is
+// written under a temporary name and renamed, so path always holds a complete checkpoint.
+// POSIX only. A board mapped to a file is shared with the child rather than copied, so
+// SyncMappedFile is the way to persist those.
+class BackgroundCheckpoint
+{
+public:
+    BackgroundCheckpoint() = default;
+    BackgroundCheckpoint(const BackgroundCheckpoint&) = delete;
+    BackgroundCheckpoint& operator=(const BackgroundCheckpoint&) = delete;
+    BackgroundCheckpoint(BackgroundCheckpoint&&) = delete;
+    BackgroundCheckpoint& operator=(BackgroundCheckpoint&&) = delete;
+    // Blocks until a running checkpoint is written.
+    ~BackgroundCheckpoint();
+
+    static bool IsSupported();
+
+    // False when a checkpoint is still being written, gol is mapped or the fork failed.
+    bool Start(const GameOfLife_BitPacked& gol, std::uint64_t generation, const std::string& path);
+    bool IsRunning();
+    // Blocks until the last started checkpoint is written and returns whether that worked; false
+    // when there is no result left to report, or when an earlier checkpoint failed and no Wait
+    // has reported that yet.
+    bool Wait();
+
+    // How long the parent was stopped in the last Start.
+    long long ForkMicroseconds() const
+    {
+        return m_forkMicroseconds;
+    }
+
+private:
+    long long m_pid = -1;
+    bool m_hasResult = false;
+    bool m_succeeded = false;
+    bool m_earlierFailed = false;
+    long long m_forkMicroseconds = 0;
+};
@@ -0,0 +1,240 @@
+#include <Compression.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    constexpr int MinMatch = 4;
+    constexpr std::size_t MaxOffset = 65535;
+    constexpr int HashBits = 14;
+    // the last bytes are always literals, so the match search can read 4 bytes without checks
+    constexpr std::size_t LastLiterals = 5;
+
+    void PutVarint(std::vector<std::uint8_t>& out, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    bool GetVarint(const std::uint8_t*& data, const std::uint8_t* end, std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (data == end)
+                return false;
+            auto byte = *data++;
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    std::uint32_t Read32(const std::uint8_t* data)
+    {
+        std::uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    // Zero runs as varint(n << 1), other runs as varint(n << 1 | 1) followed by the n words.
+    std::vector<std::uint8_t> EncodeRuns(const Word* words, std::size_t nrWords)
+    {
+        auto out = std::vector<std::uint8_t>();
+        out.reserve(nrWords + 16);
+        std::size_t i = 0;
+        while (i < nrWords)
+        {
+            auto end = i;
+            auto zero = words[i] == 0;
+            while (end < nrWords && (words[end] == 0) == zero)
+                end++;
+
+            PutVarint(out, (static_cast<std::uint64_t>(end - i) << 1) | (zero ? 0 : 1));
+            if (!zero)
+            {
+                auto offset = out.size();
+                out.resize(offset + (end - i) * sizeof(Word));
+                std::memcpy(out.data() + offset, words + i, (end - i) * sizeof(Word));
+            }
+            i = end;
+        }
+        return out;
+    }
+
+    bool DecodeRuns(const std::uint8_t* data, const std::uint8_t* end, Word* words, std::size_t nrWords)
+    {
+        std::size_t i = 0;
+        while (data != end)
+        {
+            auto token = std::uint64_t(0);
+            if (!GetVarint(data, end, token))
+                return false;
+            auto length = token >> 1;
+            if (length > nrWords - i)
+                return false;
+
+            if (token & 1)
+            {
+                if (static_cast<std::size_t>(end - data) < length * sizeof(Word))
+                    return false;
+                std::memcpy(words + i, data, length * sizeof(Word));
+                data += length * sizeof(Word);
+            }
+            else
+            {
+                std::memset(words + i, 0, length * sizeof(Word));
+            }
+            i += length;
+        }
+        return i == nrWords;
+    }
+
+    void PutLength(std::vector<std::uint8_t>& out, std::size_t length)
+    {
+        for (; length >= 255; length -= 255)
+            out.push_back(255);
+        out.push_back(static_cast<std::uint8_t>(length));
+    }
+
+    bool GetLength(const std::uint8_t*& data, const std::uint8_t* end, std::size_t& length)
+    {
+        std::uint8_t byte;
+        do
+        {
+            if (data == end)
+                return false;
+            byte = *data++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    // LZ4 block layout: a token with the literal count in the high nibble and the match length
+    // minus 4 in the low nibble, 15 meaning more length bytes follow, then the literals, then a
+    // 2-byte match offset. The last sequence has literals only.
+    void EncodeLz(const std::uint8_t* data, std::size_t size, std::vector<std::uint8_t>& out)
+    {
+        auto emit = [&](std::size_t literalStart, std::size_t literalCount, std::size_t offset, std::size_t matchLength)
+        {
+            auto literalNibble = std::min<std::size_t>(literalCount, 15);
+            auto matchNibble = matchLength ? std::min<std::size_t>(matchLength - MinMatch, 15) : 0;
+            out.push_back(static_cast<std::uint8_t>(literalNibble << 4 | matchNibble));
+            if (literalNibble == 15)
+                PutLength(out, literalCount - 15);
+            out.insert(out.end(), data + literalStart, data + literalStart + literalCount);
+            if (!matchLength)
+                return;
+            out.push_back(static_cast<std::uint8_t>(offset));
+            out.push_back(static_cast<std::uint8_t>(offset >> 8));
+            if (matchNibble == 15)
+                PutLength(out, matchLength - MinMatch - 15);
+        };
+
+        auto table = std::vector<std::uint32_t>(std::size_t(1) << HashBits, 0);
+        std::size_t anchor = 0;
+        std::size_t position = 1;
+        // incompressible stretches are skipped faster the longer they get
+        std::size_t misses = 0;
+        while (size > LastLiterals && position + MinMatch <= size - LastLiterals)
+        {
+            auto sequence = Read32(data + position);
+            auto hash = (sequence * 2654435761u) >> (32 - HashBits);
+            auto candidate = static_cast<std::size_t>(table[hash]);
+            table[hash] = static_cast<std::uint32_t>(position);
+            if (position - candidate > MaxOffset || Read32(data + candidate) != sequence)
+            {
+                position += 1 + (misses++ >> 6);
+                continue;
+            }
+
+            auto length = std::size_t(MinMatch);
+            while (position + length < size - LastLiterals && data[candidate + length] == data[position + length])
+                length++;
+
+            emit(anchor, position - anchor, position - candidate, length);
+            position += length;
+            anchor = position;
+            misses = 0;
+        }
+        emit(anchor, size - anchor, 0, 0);
+    }
+
+    bool DecodeLz(const std::uint8_t* data, const std::uint8_t* end, std::uint8_t* out, std::size_t size)
+    {
+        std::size_t position = 0;
+        while (data != end)
+        {
+            auto token = *data++;
+            auto literalCount = std::size_t(token >> 4);
+            if (literalCount == 15 && !GetLength(data, end, literalCount))
+                return false;
+            if (static_cast<std::size_t>(end - data) < literalCount || size - position < literalCount)
+                return false;
+            // an empty run stream has no buffer at all
+            if (literalCount > 0)
+                std::memcpy(out + position, data, literalCount);
+            data += literalCount;
+            position += literalCount;
+            if (data == end)
+                break;
+
+            if (end - data < 2)
+                return false;
+            auto offset = static_cast<std::size_t>(data[0]) | static_cast<std::size_t>(data[1]) << 8;
+            data += 2;
+            auto matchLength = std::size_t(token & 15);
+            if (matchLength == 15 && !GetLength(data, end, matchLength))
+                return false;
+            matchLength += MinMatch;
+            if (offset == 0 || offset > position || size - position < matchLength)
+                return false;
+
+            // byte by byte, matches may overlap what they produce
+            const auto* match = out + position - offset;
+            for (std::size_t i = 0; i < matchLength; i++)
+                out[position + i] = match[i];
+            position += matchLength;
+        }
+        return position == size;
+    }
+}
+
+namespace Compression
+{
+    std::vector<std::uint8_t> EncodeWords(const Word* words, std::size_t nrWords)
+    {
+        auto runs = EncodeRuns(words, nrWords);
+        auto out = std::vector<std::uint8_t>();
+        out.reserve(runs.size() + runs.size() / 255 + 16);
+        PutVarint(out, runs.size());
+        EncodeLz(runs.data(), runs.size(), out);
+        return out;
+    }
+
+    bool DecodeWords(const std::uint8_t* data, std::size_t size, Word* words, std::size_t nrWords)
+    {
+        const auto* end = data + size;
+        auto runsSize = std::uint64_t(0);
+        // a literal run costs at most 10 bytes on top of its words, so anything larger is corrupt
+        if (!GetVarint(data, end, runsSize) || runsSize > nrWords * (sizeof(Word) + 10) + 16)
+            return false;
+
+        auto runs = std::vector<std::uint8_t>(static_cast<std::size_t>(runsSize));
+        return DecodeLz(data, end, runs.data(), runs.size()) && DecodeRuns(runs.data(), runs.data() + runs.size(), words, nrWords);
+    }
+
+    std::uint64_t Checksum(const Word* words, std::size_t nrWords)
+    {
+        auto hash = std::uint64_t(0xCBF29CE484222325ull);
+        for (std::size_t i = 0; i < nrWords; i++)
+            hash = (hash ^ words[i]) * 0x100000001B3ull;
+        return hash;
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <BitKernels.h>
+
+// Fast lossless codec for runs of board words, with no external dependency. Words first go
+// through a word-level run-length pass that collapses the empty space, then the bytes of that
+// through an LZ4-style byte LZ that catches repeated structure such as still lifes and
+// oscillator rows. Both passes are single-pass and branch-light, so a band compresses at
+// close to memory speed.
+namespace Compression
+{
+    std::vector<std::uint8_t> EncodeWords(const Word* words, std::size_t nrWords);
+    // False when data is corrupt or does not decode to exactly nrWords words.
+    bool DecodeWords(const std::uint8_t* data, std::size_t size, Word* words, std::size_t nrWords);
+
+    // FNV-1a over words, to detect corrupt checkpoints.
+    std::uint64_t Checksum(const Word* words, std::size_t nrWords);
+}
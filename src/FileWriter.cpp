@@ -0,0 +1,685 @@
+#include <FileWriter.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GOL_POSIX 1
+#include <atomic>
+#include <cerrno>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <ThreadUtils.h>
+#if defined(__linux__)
+#define GOL_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+const char* WriteBackendName(WriteBackend backend)
+{
+    return backend == WriteBackend::IoUring ? "io_uring" : "pwrite threads";
+}
+
+// Writes whole chunks at given offsets. Chunks are identified by their index; a chunk handed out
+// by AcquireChunk belongs to the caller until it is submitted.
+struct FileWriter::Engine
+{
+    virtual ~Engine() = default;
+
+    // Waits while all chunks are being written; -1 once a write failed.
+    virtual int AcquireChunk() = 0;
+    // Hands back a chunk that is not going to be submitted.
+    virtual void ReleaseChunk(int chunk) = 0;
+    virtual void Submit(int chunk, std::size_t bytes, std::uint64_t offset) = 0;
+    // Waits for all writes, cuts the file to size and closes it; false when anything failed.
+    virtual bool Finish(std::uint64_t size) = 0;
+};
+
+namespace
+{
+    using Engine = FileWriter::Engine;
+
+#if GOL_POSIX
+    // A short write is continued from the last whole block of alignment, so that the rest of an
+    // O_DIRECT write stays aligned.
+    bool WriteAll(int fd, const std::uint8_t* data, std::size_t size, std::uint64_t offset, std::size_t alignment)
+    {
+        while (size > 0)
+        {
+            auto written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written > 0)
+                written = static_cast<ssize_t>(static_cast<std::size_t>(written) / alignment * alignment);
+            if (written <= 0)
+                return false;
+            data += written;
+            size -= static_cast<std::size_t>(written);
+            offset += static_cast<std::uint64_t>(written);
+        }
+        return true;
+    }
+
+    // O_DIRECT first; file systems such as tmpfs refuse it, and those get the page cache.
+    int OpenFile(const std::string& path, bool& direct)
+    {
+        constexpr int Flags = O_WRONLY | O_CREAT | O_TRUNC;
+#if defined(O_DIRECT)
+        auto fd = ::open(path.c_str(), Flags | O_DIRECT, 0644);
+        direct = fd >= 0;
+        if (fd >= 0 || errno != EINVAL)
+            return fd;
+#endif
+        direct = false;
+        return ::open(path.c_str(), Flags, 0644);
+    }
+
+    class PosixEngine : public Engine
+    {
+    public:
+        PosixEngine(int fd, bool direct, std::uint8_t* chunks, std::size_t chunkBytes) :
+            m_fd(fd),
+            m_direct(direct),
+            m_chunks(chunks),
+            m_chunkBytes(chunkBytes)
+        {
+        }
+        ~PosixEngine() override
+        {
+            if (m_fd >= 0)
+                ::close(m_fd);
+        }
+
+        bool Finish(std::uint64_t size) override
+        {
+            auto ok = Drain();
+            // only a direct file can have padding after the last byte
+            if (m_direct)
+                ok = ::ftruncate(m_fd, static_cast<off_t>(size)) == 0 && ok;
+            ok = ::close(m_fd) == 0 && ok;
+            m_fd = -1;
+            return ok;
+        }
+
+    protected:
+        virtual bool Drain() = 0;
+
+        std::size_t WriteAlignment() const
+        {
+            return m_direct ? FileWriter::Alignment : 1;
+        }
+
+        std::uint8_t* Chunk(int chunk) const
+        {
+            return m_chunks + static_cast<std::size_t>(chunk) * m_chunkBytes;
+        }
+
+        int m_fd;
+        bool m_direct;
+        std::uint8_t* m_chunks;
+        std::size_t m_chunkBytes;
+    };
+
+    class ThreadEngine : public PosixEngine
+    {
+    public:
+        ThreadEngine(int fd, bool direct, std::uint8_t* chunks, std::size_t chunkBytes, int queueDepth) :
+            PosixEngine(fd, direct, chunks, chunkBytes),
+            m_queueDepth(queueDepth),
+            m_jobs(queueDepth),
+            m_free(queueDepth)
+        {
+            for (int chunk = 0; chunk < queueDepth; chunk++)
+                m_free.Push(chunk);
+
+            // a few writers are enough to keep a device queue full, more only contend on the inode
+            auto nrThreads = std::min(queueDepth, 4);
+            for (int i = 0; i < nrThreads; i++)
+            {
+                m_threads.emplace_back([this]
+                {
+                    auto job = Job();
+                    while (m_jobs.Pop(job))
+                    {
+                        if (!WriteAll(m_fd, Chunk(job.chunk), job.bytes, job.offset, WriteAlignment()))
+                            m_failed = true;
+                        m_free.Push(job.chunk);
+                    }
+                });
+            }
+        }
+        ~ThreadEngine() override
+        {
+            m_jobs.Close();
+            for (auto& thread : m_threads)
+                thread.join();
+        }
+
+        int AcquireChunk() override
+        {
+            auto chunk = 0;
+            m_free.Pop(chunk);
+            if (!m_failed)
+                return chunk;
+            m_free.Push(chunk);
+            return -1;
+        }
+
+        void ReleaseChunk(int chunk) override
+        {
+            m_free.Push(chunk);
+        }
+
+        void Submit(int chunk, std::size_t bytes, std::uint64_t offset) override
+        {
+            m_jobs.Push(Job{ chunk, bytes, offset });
+        }
+
+    protected:
+        bool Drain() override
+        {
+            // all chunks back in the free queue means no write is left
+            auto chunks = std::vector<int>(m_queueDepth);
+            for (auto& chunk : chunks)
+                m_free.Pop(chunk);
+            for (auto chunk : chunks)
+                m_free.Push(chunk);
+            return !m_failed;
+        }
+
+    private:
+        struct Job
+        {
+            int chunk;
+            std::size_t bytes;
+            std::uint64_t offset;
+        };
+
+        const int m_queueDepth;
+        BoundedQueue<Job> m_jobs;
+        BoundedQueue<int> m_free;
+        std::atomic<bool> m_failed{ false };
+        std::vector<std::thread> m_threads;
+    };
+#endif
+
+#if GOL_IO_URING
+    // io_uring through the raw system calls, so that liburing is not needed: one submission per
+    // chunk, reaped when a chunk is needed again. Everything happens on the calling thread.
+    class UringEngine : public PosixEngine
+    {
+    public:
+        static std::unique_ptr<UringEngine> Create(int fd, bool direct, std::uint8_t* chunks, std::size_t chunkBytes, int queueDepth)
+        {
+            auto engine = std::unique_ptr<UringEngine>(new UringEngine(fd, direct, chunks, chunkBytes, queueDepth));
+            if (!engine->Setup())
+            {
+                // the caller still owns fd
+                engine->m_fd = -1;
+                return nullptr;
+            }
+            return engine;
+        }
+        ~UringEngine() override
+        {
+            if (m_sqes)
+                ::munmap(m_sqes, m_sqesBytes);
+            if (m_cqRing && m_cqRing != m_sqRing)
+                ::munmap(m_cqRing, m_cqRingBytes);
+            if (m_sqRing)
+                ::munmap(m_sqRing, m_sqRingBytes);
+            if (m_ring >= 0)
+                ::close(m_ring);
+        }
+
+        int AcquireChunk() override
+        {
+            while (m_free.empty() && !m_failed)
+            {
+                if (!Reap(true))
+                    m_failed = true;
+            }
+            if (m_failed)
+                return -1;
+            auto chunk = m_free.back();
+            m_free.pop_back();
+            return chunk;
+        }
+
+        void ReleaseChunk(int chunk) override
+        {
+            m_free.push_back(chunk);
+        }
+
+        void Submit(int chunk, std::size_t bytes, std::uint64_t offset) override
+        {
+            m_writes[chunk] = PendingWrite{ { Chunk(chunk), bytes }, offset };
+
+            // at most queueDepth writes are in flight, so there is always a free entry
+            auto tail = *m_sqTail;
+            auto index = tail & *m_sqMask;
+            auto& sqe = m_sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_WRITEV;
+            sqe.fd = m_fd;
+            sqe.addr = reinterpret_cast<std::uint64_t>(&m_writes[chunk].vector);
+            sqe.len = 1;
+            sqe.off = offset;
+            sqe.user_data = static_cast<std::uint64_t>(chunk);
+            m_sqArray[index] = index;
+            __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+            while (Enter(1, 0, 0) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                // completion queue pressure, room is made by reaping
+                if ((errno == EAGAIN || errno == EBUSY) && Reap(false))
+                    continue;
+                m_failed = true;
+                // an entry the kernel has taken completes like any other; one it has not is
+                // withdrawn, so no later enter can submit it while its chunk is reused
+                if (__atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) == tail)
+                {
+                    __atomic_store_n(m_sqTail, tail, __ATOMIC_RELEASE);
+                    m_free.push_back(chunk);
+                    return;
+                }
+                break;
+            }
+            m_inFlight++;
+        }
+
+    protected:
+        bool Drain() override
+        {
+            while (m_inFlight > 0)
+            {
+                if (!Reap(true))
+                    return false;
+            }
+            return !m_failed;
+        }
+
+    private:
+        struct PendingWrite
+        {
+            iovec vector;
+            std::uint64_t offset;
+        };
+
+        UringEngine(int fd, bool direct, std::uint8_t* chunks, std::size_t chunkBytes, int queueDepth) :
+            PosixEngine(fd, direct, chunks, chunkBytes),
+            m_queueDepth(queueDepth),
+            m_writes(queueDepth)
+        {
+            for (int chunk = queueDepth - 1; chunk >= 0; chunk--)
+                m_free.push_back(chunk);
+        }
+
+        bool Setup()
+        {
+            auto params = io_uring_params();
+            m_ring = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(m_queueDepth), &params));
+            if (m_ring < 0)
+                return false;
+
+            m_sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            m_cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            auto singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap)
+                m_sqRingBytes = m_cqRingBytes = std::max(m_sqRingBytes, m_cqRingBytes);
+
+            m_sqRing = Map(m_sqRingBytes, IORING_OFF_SQ_RING);
+            if (!m_sqRing)
+                return false;
+            m_cqRing = singleMap ? m_sqRing : Map(m_cqRingBytes, IORING_OFF_CQ_RING);
+            if (!m_cqRing)
+                return false;
+            m_sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+            m_sqes = static_cast<io_uring_sqe*>(Map(m_sqesBytes, IORING_OFF_SQES));
+            if (!m_sqes)
+                return false;
+
+            auto* sq = static_cast<std::uint8_t*>(m_sqRing);
+            auto* cq = static_cast<std::uint8_t*>(m_cqRing);
+            m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            m_sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            m_cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        void* Map(std::size_t size, off_t offset) const
+        {
+            auto* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ring, offset);
+            return data == MAP_FAILED ? nullptr : data;
+        }
+
+        int Enter(unsigned toSubmit, unsigned minComplete, unsigned flags) const
+        {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, m_ring, toSubmit, minComplete, flags, nullptr, 0));
+        }
+
+        // Takes all completions, waiting for one when wait is set and there are none; false when
+        // the ring itself failed.
+        bool Reap(bool wait)
+        {
+            auto head = *m_cqHead;
+            auto tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+            while (head == tail && wait)
+            {
+                if (Enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                    return false;
+                tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+            }
+
+            for (; head != tail; head++)
+            {
+                const auto& cqe = m_cqes[head & *m_cqMask];
+                auto chunk = static_cast<int>(cqe.user_data);
+                const auto& write = m_writes[chunk];
+                // short writes are finished synchronously, they only happen near a full disk; like
+                // in WriteAll they go on from a whole block
+                auto written = static_cast<std::size_t>(std::max(cqe.res, 0)) / WriteAlignment() * WriteAlignment();
+                if (cqe.res < 0 || (written < write.vector.iov_len &&
+                    !WriteAll(m_fd, static_cast<const std::uint8_t*>(write.vector.iov_base) + written, write.vector.iov_len - written, write.offset + written, WriteAlignment())))
+                    m_failed = true;
+                m_free.push_back(chunk);
+                m_inFlight--;
+            }
+            __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+            return true;
+        }
+
+        const int m_queueDepth;
+        int m_ring = -1;
+        void* m_sqRing = nullptr;
+        void* m_cqRing = nullptr;
+        io_uring_sqe* m_sqes = nullptr;
+        std::size_t m_sqRingBytes = 0;
+        std::size_t m_cqRingBytes = 0;
+        std::size_t m_sqesBytes = 0;
+        unsigned* m_sqHead = nullptr;
+        unsigned* m_sqTail = nullptr;
+        unsigned* m_sqMask = nullptr;
+        unsigned* m_sqArray = nullptr;
+        unsigned* m_cqHead = nullptr;
+        unsigned* m_cqTail = nullptr;
+        unsigned* m_cqMask = nullptr;
+        io_uring_cqe* m_cqes = nullptr;
+
+        std::vector<PendingWrite> m_writes;
+        std::vector<int> m_free;
+        int m_inFlight = 0;
+        bool m_failed = false;
+    };
+#endif
+
+#if GOL_POSIX
+    std::unique_ptr<Engine> OpenEngine(const std::string& path, WriteBackend backend, std::uint8_t* chunks, std::size_t chunkBytes, int queueDepth,
+        WriteBackend& actualBackend, bool& direct)
+    {
+        auto fd = OpenFile(path, direct);
+        if (fd < 0)
+            return nullptr;
+
+#if GOL_IO_URING
+        // kernels before 5.1, or sandboxes that filter the calls, take the threads
+        if (backend == WriteBackend::IoUring)
+        {
+            if (auto engine = UringEngine::Create(fd, direct, chunks, chunkBytes, queueDepth))
+            {
+                actualBackend = WriteBackend::IoUring;
+                return engine;
+            }
+        }
+#else
+        (void)backend;
+#endif
+        actualBackend = WriteBackend::Threads;
+        return std::make_unique<ThreadEngine>(fd, direct, chunks, chunkBytes, queueDepth);
+    }
+#else
+    // Without pwrite every chunk is written before the next one is handed out.
+    class StdioEngine : public Engine
+    {
+    public:
+        StdioEngine(std::FILE* file, std::uint8_t* chunks) :
+            m_file(file),
+            m_chunks(chunks)
+        {
+        }
+        ~StdioEngine() override
+        {
+            if (m_file)
+                std::fclose(m_file);
+        }
+
+        int AcquireChunk() override
+        {
+            return m_failed ? -1 : 0;
+        }
+
+        void ReleaseChunk(int) override
+        {
+        }
+
+        void Submit(int, std::size_t bytes, std::uint64_t) override
+        {
+            if (std::fwrite(m_chunks, 1, bytes, m_file) != bytes)
+                m_failed = true;
+        }
+
+        bool Finish(std::uint64_t) override
+        {
+            auto ok = std::fclose(m_file) == 0 && !m_failed;
+            m_file = nullptr;
+            return ok;
+        }
+
+    private:
+        std::FILE* m_file;
+        std::uint8_t* m_chunks;
+        bool m_failed = false;
+    };
+
+    std::unique_ptr<Engine> OpenEngine(const std::string& path, WriteBackend, std::uint8_t* chunks, std::size_t, int,
+        WriteBackend& actualBackend, bool& direct)
+    {
+        auto* file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            return nullptr;
+        actualBackend = WriteBackend::Threads;
+        direct = false;
+        return std::make_unique<StdioEngine>(file, chunks);
+    }
+#endif
+}
+
+FileWriter::FileWriter() = default;
+
+FileWriter::~FileWriter()
+{
+    if (m_engine)
+        Close();
+}
+
+bool FileWriter::Open(const std::string& path, WriteBackend backend, std::size_t chunkBytes, int queueDepth)
+{
+    if (m_engine)
+        Close();
+
+    m_chunkBytes = std::max(Alignment, (chunkBytes + Alignment - 1) / Alignment * Alignment);
+    queueDepth = std::max(queueDepth, 1);
+    m_storage.assign(m_chunkBytes * queueDepth + Alignment, 0);
+    auto address = reinterpret_cast<std::uintptr_t>(m_storage.data());
+    m_chunks = m_storage.data() + ((Alignment - address % Alignment) % Alignment);
+
+    m_engine = OpenEngine(path, backend, m_chunks, m_chunkBytes, queueDepth, m_backend, m_direct);
+    if (!m_engine)
+        return false;
+
+    m_failed = false;
+    m_fill = 0;
+    m_offset = 0;
+    m_chunk = m_engine->AcquireChunk();
+    return true;
+}
+
+bool FileWriter::Write(const void* data, std::size_t size)
+{
+    if (!m_engine || m_failed)
+        return false;
+
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    while (size > 0)
+    {
+        auto count = std::min(size, m_chunkBytes - m_fill);
+        std::memcpy(m_chunks + static_cast<std::size_t>(m_chunk) * m_chunkBytes + m_fill, bytes, count);
+        m_fill += count;
+        bytes += count;
+        size -= count;
+        if (m_fill < m_chunkBytes)
+            continue;
+
+        SubmitChunk();
+        m_chunk = m_engine->AcquireChunk();
+        if (m_chunk < 0)
+        {
+            m_failed = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FileWriter::Close()
+{
+    if (!m_engine)
+        return false;
+
+    // the chunk being filled goes back even when it is empty, the engine waits for all of them
+    if (m_chunk >= 0)
+    {
+        if (!m_failed && m_fill > 0)
+            SubmitChunk();
+        else
+            m_engine->ReleaseChunk(m_chunk);
+    }
+    auto ok = m_engine->Finish(m_offset) && !m_failed;
+    m_engine.reset();
+    m_chunk = -1;
+    return ok;
+}
+
+void FileWriter::SubmitChunk()
+{
+    auto bytes = m_fill;
+    if (m_direct && bytes % Alignment != 0)
+    {
+        // direct writes are whole blocks, Finish cuts the zeros off again
+        auto padded = (bytes + Alignment - 1) / Alignment * Alignment;
+        std::memset(m_chunks + static_cast<std::size_t>(m_chunk) * m_chunkBytes + bytes, 0, padded - bytes);
+        bytes = padded;
+    }
+    m_engine->Submit(m_chunk, bytes, m_offset);
+    m_offset += m_fill;
+    m_fill = 0;
+}
+
+namespace
+{
+    constexpr std::size_t StreamBufferBytes = std::size_t(1) << 16;
+}
+
+FileWriterStream::Buffer::Buffer() :
+    put(StreamBufferBytes)
+{
+    setp(put.data(), put.data() + put.size());
+}
+
+FileWriterStream::Buffer::int_type FileWriterStream::Buffer::overflow(int_type c)
+{
+    if (sync() != 0)
+        return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize FileWriterStream::Buffer::xsputn(const char* data, std::streamsize size)
+{
+    auto count = static_cast<std::size_t>(size);
+    if (count > static_cast<std::size_t>(epptr() - pptr()))
+    {
+        if (sync() != 0)
+            return 0;
+        // large blocks such as packed rows skip the put area
+        if (count >= put.size())
+            return writer.Write(data, count) ? size : 0;
+    }
+    std::memcpy(pptr(), data, count);
+    pbump(static_cast<int>(count));
+    return size;
+}
+
+int FileWriterStream::Buffer::sync()
+{
+    auto ok = writer.Write(pbase(), static_cast<std::size_t>(pptr() - pbase()));
+    setp(put.data(), put.data() + put.size());
+    return ok ? 0 : -1;
+}
+
+FileWriterStream::FileWriterStream() :
+    std::ostream(&m_buffer)
+{
+}
+
+FileWriterStream::FileWriterStream(const std::string& path, WriteBackend backend) :
+    std::ostream(&m_buffer)
+{
+    Open(path, backend);
+}
+
+FileWriterStream::~FileWriterStream()
+{
+    if (m_buffer.writer.IsOpen())
+        Close();
+}
+
+bool FileWriterStream::Open(const std::string& path, WriteBackend backend)
+{
+    if (m_buffer.writer.IsOpen())
+        Close();
+    if (!m_buffer.writer.Open(path, backend))
+    {
+        setstate(std::ios::failbit);
+        return false;
+    }
+    clear();
+    return true;
+}
+
+bool FileWriterStream::Close()
+{
+    auto ok = m_buffer.pubsync() == 0;
+    ok = m_buffer.writer.Close() && ok;
+    if (!ok)
+        setstate(std::ios::failbit);
+    return ok;
+}
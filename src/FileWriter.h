@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+enum class WriteBackend
+{
+    IoUring,    // chunks submitted through an io_uring, Linux only
+    Threads,    // chunks handed to threads doing pwrite
+};
+
+const char* WriteBackendName(WriteBackend backend);
+
+// Sequential writer for large outputs such as checkpoints and frame dumps. Data is gathered in
+// page aligned chunks, and full chunks are written while the next ones fill, several at a time,
+// so the producer keeps going at memory speed while the disk is kept busy. The file is opened
+// with O_DIRECT where the file system allows it, which keeps gigabytes of output from pushing
+// everything else out of the page cache; the last chunk is padded to the alignment and the
+// padding is cut off again in Close. When the requested backend is not available the pwrite
+// threads are used, and on systems without pwrite a plain synchronous write.
+class FileWriter
+{
+public:
+    static constexpr std::size_t Alignment = 4096;
+    static constexpr std::size_t DefaultChunkBytes = std::size_t(1) << 20;
+    static constexpr int DefaultQueueDepth = 8;
+
+    FileWriter();
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+    FileWriter(FileWriter&&) = delete;
+    FileWriter& operator=(FileWriter&&) = delete;
+    ~FileWriter();
+
+    // Creates or truncates path. chunkBytes is rounded up to the alignment, queueDepth is the
+    // number of chunks that can be in flight.
+    bool Open(const std::string& path, WriteBackend backend = WriteBackend::IoUring,
+        std::size_t chunkBytes = DefaultChunkBytes, int queueDepth = DefaultQueueDepth);
+    // False once any write failed; the error sticks until Close.
+    bool Write(const void* data, std::size_t size);
+    // Writes what is left and waits for all writes; false when any of them failed.
+    bool Close();
+
+    bool IsOpen() const
+    {
+        return m_engine != nullptr;
+    }
+    // The backend actually in use, which differs from the requested one after a fallback.
+    WriteBackend Backend() const
+    {
+        return m_backend;
+    }
+    bool IsDirect() const
+    {
+        return m_direct;
+    }
+    std::uint64_t BytesWritten() const
+    {
+        return m_offset + m_fill;
+    }
+
+    struct Engine;
+
+private:
+    void SubmitChunk();
+
+    // declared before the engine, so that no write still in flight outlives the chunks
+    std::vector<std::uint8_t> m_storage;
+    std::uint8_t* m_chunks = nullptr;   // m_storage, aligned
+    std::unique_ptr<Engine> m_engine;
+    WriteBackend m_backend = WriteBackend::Threads;
+    bool m_direct = false;
+    bool m_failed = false;
+    std::size_t m_chunkBytes = 0;
+    int m_chunk = -1;                   // the chunk being filled
+    std::size_t m_fill = 0;
+    std::uint64_t m_offset = 0;         // of the chunk being filled
+};
+
+// std::ostream on top of a FileWriter, for the exporters that write to streams.
+class FileWriterStream : public std::ostream
+{
+public:
+    FileWriterStream();
+    FileWriterStream(const std::string& path, WriteBackend backend = WriteBackend::IoUring);
+    ~FileWriterStream() override;
+
+    bool Open(const std::string& path, WriteBackend backend = WriteBackend::IoUring);
+    // Flushes and closes the file, sets failbit when anything could not be written.
+    bool Close();
+
+    const FileWriter& Writer() const
+    {
+        return m_buffer.writer;
+    }
+
+private:
+    // Small put area in front of the writer, so that single characters do not cost a call each.
+    struct Buffer : std::streambuf
+    {
+        Buffer();
+
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* data, std::streamsize size) override;
+        int sync() override;
+
+        FileWriter writer;
+        std::vector<char> put;
+    };
+
+    Buffer m_buffer;
+};
@@ -0,0 +1,270 @@
+#include <HaloTransport.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GOL_POSIX 1
+#endif
+
+#if GOL_POSIX
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <poll.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+const char* HaloTransportName(HaloTransport transport)
+{
+    return transport == HaloTransport::UnixSocket ? "unix socket" : "shared memory";
+}
+
+#if GOL_POSIX
+namespace
+{
+    class SocketLink : public HaloLink
+    {
+    public:
+        explicit SocketLink(int fd) :
+            m_fd(fd)
+        {
+        }
+        ~SocketLink() override
+        {
+            Close();
+        }
+
+        bool Send(const void* data, std::size_t size) override
+        {
+            const auto* bytes = static_cast<const char*>(data);
+            while (size > 0)
+            {
+                auto written = ::send(m_fd, bytes, size, MSG_NOSIGNAL);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    return false;
+                bytes += written;
+                size -= static_cast<std::size_t>(written);
+            }
+            return true;
+        }
+
+        bool Receive(void* data, std::size_t size) override
+        {
+            auto* bytes = static_cast<char*>(data);
+            while (size > 0)
+            {
+                auto nrRead = ::read(m_fd, bytes, size);
+                if (nrRead < 0 && errno == EINTR)
+                    continue;
+                if (nrRead <= 0)
+                    return false;
+                bytes += nrRead;
+                size -= static_cast<std::size_t>(nrRead);
+            }
+            return true;
+        }
+
+        void Close() override
+        {
+            if (m_fd >= 0)
+                ::close(m_fd);
+            m_fd = -1;
+        }
+
+    private:
+        int m_fd;
+    };
+
+    // Single-slot mailbox for one direction. The writer fills data and then bumps written; the
+    // reader copies it out and then bumps read. Larger messages go through in capacity pieces.
+    struct Mailbox
+    {
+        static constexpr std::size_t Capacity = std::size_t(1) << 16;
+
+        alignas(64) std::atomic<std::uint32_t> written{ 0 };
+        alignas(64) std::atomic<std::uint32_t> read{ 0 };
+        std::size_t size = 0;
+        char data[Capacity];
+    };
+
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "the mailbox counters are shared between processes");
+
+    // True once every copy of the other end of a liveness socket is closed, which the kernel also
+    // does for a process that crashed or was killed.
+    bool PeerGone(int fd)
+    {
+        auto peer = pollfd{ fd, POLLIN, 0 };
+        return ::poll(&peer, 1, 0) > 0;
+    }
+
+    // Waits until word no longer holds value; false when the process on the other end of fd went
+    // away first. The words live in memory shared between processes, so this uses a shared futex
+    // rather than anything tied to one process, with a timeout to look at the other end now and
+    // then.
+    bool WaitWhileEqual(const std::atomic<std::uint32_t>& word, std::uint32_t value, int fd)
+    {
+        for (int spin = 0; spin < 1024; spin++)
+        {
+            if (word.load(std::memory_order_acquire) != value)
+                return true;
+        }
+        for (int wait = 1; word.load(std::memory_order_acquire) == value; wait++)
+        {
+#if defined(__linux__)
+            auto timeout = timespec{ 0, 50 * 1000 * 1000 };
+            auto woken = syscall(SYS_futex, const_cast<std::atomic<std::uint32_t>*>(&word), FUTEX_WAIT, value, &timeout, nullptr, 0) == 0;
+            auto look = !woken;
+#else
+            sched_yield();
+            auto look = wait % 1024 == 0;
+#endif
+            // a word stored before the other end went away still counts
+            if (look && PeerGone(fd))
+                return word.load(std::memory_order_acquire) != value;
+        }
+        return true;
+    }
+
+    void Wake(std::atomic<std::uint32_t>& word)
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, &word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+        (void)word;
+#endif
+    }
+
+    struct SharedRegion
+    {
+        Mailbox mailboxes[2];
+    };
+
+    // The mailboxes carry pieces, while a Receive may ask for less or more than one Send wrote, so
+    // the reader keeps its position in the current piece. Next to the shared mapping each end
+    // holds one side of a socketpair that never carries data: it is closed along with the process
+    // using the end, and waits look at it so that they fail instead of blocking forever when that
+    // process is gone.
+    class SharedMemoryLink : public HaloLink
+    {
+    public:
+        SharedMemoryLink(std::shared_ptr<SharedRegion> region, int side, int fd) :
+            m_region(std::move(region)),
+            m_outgoing(m_region->mailboxes[side]),
+            m_incoming(m_region->mailboxes[1 - side]),
+            m_fd(fd)
+        {
+        }
+        ~SharedMemoryLink() override
+        {
+            Close();
+        }
+
+        bool Send(const void* data, std::size_t size) override
+        {
+            const auto* bytes = static_cast<const char*>(data);
+            while (size > 0)
+            {
+                auto sequence = m_outgoing.written.load(std::memory_order_relaxed);
+                if (!WaitWhileEqual(m_outgoing.read, sequence - 1, m_fd))  // the previous piece is still unread
+                    return false;
+
+                auto piece = std::min(size, Mailbox::Capacity);
+                std::memcpy(m_outgoing.data, bytes, piece);
+                m_outgoing.size = piece;
+                m_outgoing.written.store(sequence + 1, std::memory_order_release);
+                Wake(m_outgoing.written);
+
+                bytes += piece;
+                size -= piece;
+            }
+            return true;
+        }
+
+        bool Receive(void* data, std::size_t size) override
+        {
+            auto* bytes = static_cast<char*>(data);
+            while (size > 0)
+            {
+                auto sequence = m_incoming.read.load(std::memory_order_relaxed);
+                if (!WaitWhileEqual(m_incoming.written, sequence, m_fd))
+                    return false;
+
+                auto piece = std::min(size, m_incoming.size - m_readOffset);
+                std::memcpy(bytes, m_incoming.data + m_readOffset, piece);
+                m_readOffset += piece;
+                if (m_readOffset == m_incoming.size)
+                {
+                    m_readOffset = 0;
+                    m_incoming.read.store(sequence + 1, std::memory_order_release);
+                    Wake(m_incoming.read);
+                }
+
+                bytes += piece;
+                size -= piece;
+            }
+            return true;
+        }
+
+        // The mapping is shared by both ends and unmapped with the last one.
+        void Close() override
+        {
+            if (m_fd >= 0)
+                ::close(m_fd);
+            m_fd = -1;
+        }
+
+    private:
+        std::shared_ptr<SharedRegion> m_region;
+        Mailbox& m_outgoing;
+        Mailbox& m_incoming;
+        std::size_t m_readOffset = 0;   // into the current incoming piece
+        int m_fd;
+    };
+
+    std::shared_ptr<SharedRegion> MapSharedRegion()
+    {
+        auto* memory = ::mmap(nullptr, sizeof(SharedRegion), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+            return nullptr;
+
+        auto* region = new (memory) SharedRegion();
+        return std::shared_ptr<SharedRegion>(region, [](SharedRegion* mapped)
+        {
+            mapped->~SharedRegion();
+            ::munmap(mapped, sizeof(SharedRegion));
+        });
+    }
+}
+
+HaloLinkPair CreateLinkPair(HaloTransport transport)
+{
+    if (transport == HaloTransport::UnixSocket)
+    {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            return {};
+        return { std::make_unique<SocketLink>(fds[0]), std::make_unique<SocketLink>(fds[1]) };
+    }
+
+    auto region = MapSharedRegion();
+    int fds[2];
+    if (!region || ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        return {};
+    return { std::make_unique<SharedMemoryLink>(region, 0, fds[0]), std::make_unique<SharedMemoryLink>(region, 1, fds[1]) };
+}
+#else
+HaloLinkPair CreateLinkPair(HaloTransport)
+{
+    return {};
+}
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Reliable, ordered byte pipe between two processes: neighbouring band owners exchanging halo
+// rows, or a band owner and the coordinator. Both ends are created up front and handed to the
+// processes at fork time.
+class HaloLink
+{
+public:
+    virtual ~HaloLink() = default;
+
+    // Block until all bytes went through; false when the other end is gone.
+    virtual bool Send(const void* data, std::size_t size) = 0;
+    virtual bool Receive(void* data, std::size_t size) = 0;
+
+    // Releases this end in a process that will not use it.
+    virtual void Close() = 0;
+};
+
+using HaloLinkPair = std::pair<std::unique_ptr<HaloLink>, std::unique_ptr<HaloLink>>;
+
+enum class HaloTransport
+{
+    UnixSocket,     // AF_UNIX socketpair
+    SharedMemory,   // anonymous shared mapping with one mailbox per direction
+};
+
+const char* HaloTransportName(HaloTransport transport);
+
+// Both ends of a new link, or two empty pointers when the transport is not available here.
+HaloLinkPair CreateLinkPair(HaloTransport transport);
@@ -1,5 +1,6 @@
 #include <ImplGameOfLife.h>
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 #include <random>
@@ -19,20 +20,27 @@ namespace
             { 1, 1 },
         }
     };
+}
 
-    auto CoordsInBoardSize(int boardSize, int x, int y)
-    {
-        return !(x < 0 || y < 0 || x >= boardSize || y >= boardSize);
-    }
+GameOfLife::GameOfLife(int boardSize) :
+    GameOfLife(boardSize, boardSize)
+{
 }
 
-GameOfLife::GameOfLife(int boardSize) :m_boardSize(boardSize)
+GameOfLife::GameOfLife(int width, int height) :
+    m_width(width),
+    m_height(height),
+    m_nrTileRows((height + TileSize - 1) / TileSize),
+    m_nrTileCols((width + TileSize - 1) / TileSize),
+    m_activeTiles(m_nrTileRows * m_nrTileCols)
 {
-    m_board.resize(m_boardSize); // set num rows
+    MarkAllTiles();
+
+    m_board.resize(m_height); // set num rows
 
     for (auto& row : m_board)
     {
-        row.resize(m_boardSize); // set num col
+        row.resize(m_width); // set num col
     }
 }
 
@@ -46,15 +54,16 @@ void GameOfLife::InitBoardWithRandomData(unsigned seed)
     if (!isInit)
     {
         for (auto& row : m_board)
-            row.resize(m_boardSize);
+            row.resize(m_width);
 
-        for (int i = 0; i < m_boardSize; ++i)
+        for (int i = 0; i < m_height; ++i)
         {
-            for (int j = 0; j < m_boardSize; ++j)
+            for (int j = 0; j < m_width; ++j)
                 m_board[i][j] = static_cast<bool>(distribution(generator));
         }
         isInit = true;
     }
+    MarkAllTiles();
 }
 
 auto GameOfLife::at(int x, int y)
@@ -67,6 +76,7 @@ void GameOfLife::SetInitialState(const std::vector<std::pair<int, int>>& aliveCe
     for (const auto& [x, y] : aliveCellsAtStart)
     {
         at(x, y) = true;
+        MarkTilesAround(x, y);
     }
 }
 
@@ -74,12 +84,14 @@ void GameOfLife::SetInitialState(const std::vector<std::vector<bool>>& aliveCell
 {
     if (m_board.size() == aliveCellsAtStart.size() && m_board.front().size() == aliveCellsAtStart.front().size())
         m_board = aliveCellsAtStart;
+    MarkAllTiles();
 }
 
 void GameOfLife::SetInitialState(std::vector<std::vector<bool>>&& aliveCellsAtStart)
 {
     if (m_board.size() == aliveCellsAtStart.size() && m_board.front().size() == aliveCellsAtStart.front().size())
         m_board = aliveCellsAtStart;
+    MarkAllTiles();
 }
 
 State GameOfLife::GetState()
@@ -89,19 +101,79 @@ State GameOfLife::GetState()
 
 StateChanges GameOfLife::GenNextStateChanges()
 {
+    return GenNextStateChanges(Region{ 0, m_height, 0, m_width });
+}
+
+StateChanges GameOfLife::GenNextStateChanges(const Region& region)
+{
+    const auto& [startRow, endRow, startCol, endCol] = region;
     auto cellChanges = StateChanges();
 
-    for (int i = 0; i < m_boardSize; i++)
+    for (int tileRow = startRow / TileSize; tileRow * TileSize < endRow; tileRow++)
     {
-        for (int j = 0; j < m_boardSize; j++)
+        auto tileStartRow = tileRow * TileSize;
+        auto tileEndRow = tileStartRow + TileSize;
+        for (int tileCol = startCol / TileSize; tileCol * TileSize < endCol; tileCol++)
         {
-            AnalyzeStateChanges(cellChanges, i, j);
+            auto& active = m_activeTiles[tileRow * m_nrTileCols + tileCol];
+            if (!active.load(std::memory_order_relaxed))
+                continue;
+
+            auto tileStartCol = tileCol * TileSize;
+            auto tileEndCol = tileStartCol + TileSize;
+            for (int i = std::max(startRow, tileStartRow); i < std::min(endRow, tileEndRow); i++)
+            {
+                for (int j = std::max(startCol, tileStartCol); j < std::min(endCol, tileEndCol); j++)
+                {
+                    AnalyzeStateChanges(cellChanges, i, j);
+                }
+            }
+
+            // a tile shared with another region is only cleared when that region cannot still be reading it
+            auto ownsTile = startRow <= tileStartRow && std::min(tileEndRow, m_height) <= endRow &&
+                startCol <= tileStartCol && std::min(tileEndCol, m_width) <= endCol;
+            if (ownsTile)
+                active.store(0, std::memory_order_relaxed);
         }
     }
 
     return cellChanges;
 }
 
+StateChanges GameOfLife::GenNextStateChanges(const StateChanges& previousChanges)
+{
+    if (m_frontierMarks.size() != m_board.size())
+        m_frontierMarks = State(m_height, std::vector<bool>(m_width));
+
+    auto frontier = StateChanges();
+    frontier.reserve(previousChanges.size() * 3);
+    auto addToFrontier = [&](int x, int y)
+    {
+        x = WrapCoordinate(x, m_height, m_boundary);
+        y = WrapCoordinate(y, m_width, m_boundary);
+        if (x < 0 || y < 0 || m_frontierMarks[x][y])
+            return;
+        m_frontierMarks[x][y] = true;
+        frontier.emplace_back(x, y);
+    };
+
+    for (const auto& [x, y] : previousChanges)
+    {
+        addToFrontier(x, y);
+        for (const auto& [offX, offY] : Offsets)
+            addToFrontier(x + offX, y + offY);
+    }
+
+    auto cellChanges = StateChanges();
+    for (const auto& [x, y] : frontier)
+    {
+        m_frontierMarks[x][y] = false;
+        AnalyzeStateChanges(cellChanges, x, y);
+    }
+
+    return cellChanges;
+}
+
 namespace
 {
     bool isPowerOfTwo(int n)
@@ -114,7 +186,7 @@ StateChanges GameOfLife::GenNextStateChangesForRow(int row)
 {
     auto cellChanges = StateChanges();
 
-    for (int j = 0; j < m_boardSize; j++)
+    for (int j = 0; j < m_width; j++)
     {
         AnalyzeStateChanges(cellChanges, row, j);
     }
@@ -128,131 +200,116 @@ void GameOfLife::DoStateChanges(const std::vector<std::pair<int, int>>& cellChan
     for (const auto& [x, y] : cellChanges)
     {
         at(x, y) = !at(x, y);
+        MarkTilesAround(x, y);
     }
 }
 
-void GameOfLife::PrintBoardState()
+void GameOfLife::MarkTilesAround(int x, int y)
 {
-    for (int i = 0; i < m_boardSize; i++)
+    auto markTile = [&](int tileRow, int tileCol)
     {
-        for (int j = 0; j < m_boardSize; j++)
+        // no store when already set, so regions changing cells along a shared edge don't keep bouncing the line
+        auto& active = m_activeTiles[tileRow * m_nrTileCols + tileCol];
+        if (!active.load(std::memory_order_relaxed))
+            active.store(1, std::memory_order_relaxed);
+    };
+
+    if (m_boundary != Boundary::Dead && (x == 0 || y == 0 || x == m_height - 1 || y == m_width - 1))
+    {
+        // the neighbours of an edge cell can be on the other side of the board
+        for (const auto& [offX, offY] : Offsets)
         {
-            std::cout << at(i, j);
+            auto neighborX = WrapCoordinate(x + offX, m_height, m_boundary);
+            auto neighborY = WrapCoordinate(y + offY, m_width, m_boundary);
+            if (neighborX >= 0 && neighborY >= 0)
+                markTile(neighborX / TileSize, neighborY / TileSize);
         }
-        std::cout << "\n";
+        markTile(x / TileSize, y / TileSize);
+        return;
     }
-    std::cout << "------------------------------------------\n";
-}
 
-void GameOfLife::ToggleCellState(const std::pair<int, int>& cell)
-{
-    at(cell.first, cell.second) = !at(cell.first, cell.second);
+    auto firstTileRow = std::max(x - 1, 0) / TileSize;
+    auto lastTileRow = std::min(x + 1, m_height - 1) / TileSize;
+    auto firstTileCol = std::max(y - 1, 0) / TileSize;
+    auto lastTileCol = std::min(y + 1, m_width - 1) / TileSize;
+    for (auto tileRow = firstTileRow; tileRow <= lastTileRow; tileRow++)
+    {
+        for (auto tileCol = firstTileCol; tileCol <= lastTileCol; tileCol++)
+            markTile(tileRow, tileCol);
+    }
 }
 
-void GameOfLife::AnalyzeStateChanges(StateChanges& cellChanges, int i, int j)
+void GameOfLife::MarkAllTiles()
 {
-
-    auto nrAliveNeighbors = 0;
-    auto nrDeadNeighbors = 0;
-    for (const auto& [offX, offY] : Offsets)
-    {
-        if (!CoordsInBoardSize(m_boardSize, i + offX, j + offY))
-            continue;
-
-        if (at(i + offX, j + offY))
-            nrAliveNeighbors++;
-        else
-            nrDeadNeighbors++;
-    }
-    if (at(i, j)) // cell is alive
-    {
-        if (nrAliveNeighbors <= 1) // if 0 or 1 alive neighbors, the cell dies by solitude
-            cellChanges.emplace_back(i, j);
-        else if (nrAliveNeighbors >= 4) // if 4 or more alive neighbors, the cell dies by overpopulation
-            cellChanges.emplace_back(i, j);
-    }
-    else                // cell is dead
-    {
-        if (nrAliveNeighbors == 3)
-            cellChanges.emplace_back(i, j);
-    }
+    for (auto& active : m_activeTiles)
+        active.store(1, std::memory_order_relaxed);
 }
 
-template<>
-StateChanges GameOfLife::GenNextStateChanges<2>(int compIdx)
+void GameOfLife::Step(StateChanges* cellChanges)
 {
-    auto comps = 2;
-    auto compSize = m_boardSize / comps;
+    if (m_nextBoard.size() != m_board.size())
+        m_nextBoard = m_board;
 
-    auto cellChanges = StateChanges();
-    cellChanges.reserve(compSize);
-    for (int i = compIdx * compSize; i < (compIdx + 1) * compSize; i++)
+    for (int i = 0; i < m_height; i++)
     {
-        for (int j = 0; j < m_boardSize; j++)
+        auto& nextRow = m_nextBoard[i];
+        for (int j = 0; j < m_width; j++)
         {
-            AnalyzeStateChanges(cellChanges, i, j);
+            nextRow[j] = IsAliveNextGeneration(i, j);
+            if (cellChanges && nextRow[j] != at(i, j))
+                cellChanges->emplace_back(i, j);
         }
     }
 
-    return cellChanges;
+    m_board.swap(m_nextBoard);
+    MarkAllTiles();
 }
 
-template<>
-StateChanges GameOfLife::GenNextStateChanges<4>(int compIdx)
+void GameOfLife::PrintBoardState()
 {
-    auto comps = 4;
-    auto valsPerComp = comps / 2;
-
-    auto compSize = m_boardSize / valsPerComp;
-
-    auto rowIdx = compIdx / valsPerComp;
-    auto colIdx = compIdx % valsPerComp;
-
-    auto startRowIdx = rowIdx * compSize;
-    auto endRowIdx = rowIdx == 0 ? (rowIdx + 1) * compSize : m_boardSize;
-
-    auto startColIdx = colIdx * compSize;
-    auto endColIdx = colIdx == 0 ? (colIdx + 1) * compSize : m_boardSize;
-
-    auto cellChanges = StateChanges();
-    cellChanges.reserve(compSize);
-    for (auto i = startRowIdx; i < endRowIdx; i++)
+    for (int i = 0; i < m_height; i++)
     {
-        for (auto j = startColIdx; j < endColIdx; j++)
+        for (int j = 0; j < m_width; j++)
         {
-            AnalyzeStateChanges(cellChanges, i, j);
+            std::cout << at(i, j);
         }
+        std::cout << "\n";
     }
-
-    return cellChanges;
+    std::cout << "------------------------------------------\n";
 }
 
-template<>
-StateChanges GameOfLife::GenNextStateChanges<16>(int compIdx)
+void GameOfLife::ToggleCellState(const std::pair<int, int>& cell)
 {
-    auto comps = 16;
-    auto valsPerComp = comps / 4;
-
-    auto compSize = m_boardSize / valsPerComp;
-
-    auto rowIdx = compIdx / valsPerComp;
-    auto colIdx = compIdx % valsPerComp;
-
-    auto startRowIdx = rowIdx * compSize;
-    auto endRowIdx = rowIdx != (valsPerComp - 1) ? (rowIdx + 1) * compSize : m_boardSize;
+    at(cell.first, cell.second) = !at(cell.first, cell.second);
+    MarkTilesAround(cell.first, cell.second);
+}
 
-    auto startColIdx = colIdx * compSize;
-    auto endColIdx = colIdx != (valsPerComp - 1) ? (colIdx + 1) * compSize : m_boardSize;
+void GameOfLife::AnalyzeStateChanges(StateChanges& cellChanges, int i, int j)
+{
+    if (IsAliveNextGeneration(i, j) != at(i, j))
+        cellChanges.emplace_back(i, j);
+}
 
-    auto cellChanges = StateChanges();
-    cellChanges.reserve(compSize);
-    for (auto i = startRowIdx; i < endRowIdx; i++)
+bool GameOfLife::IsAliveNextGeneration(int i, int j)
+{
+    auto nrAliveNeighbors = 0;
+    if (i > 0 && j > 0 && i < m_height - 1 && j < m_width - 1)
     {
-        for (auto j = startColIdx; j < endColIdx; j++)
+        // inner cells, all neighbours are on the board
+        const auto& above = m_board[i - 1];
+        const auto& row = m_board[i];
+        const auto& below = m_board[i + 1];
+        nrAliveNeighbors = above[j - 1] + above[j] + above[j + 1] + row[j - 1] + row[j + 1] + below[j - 1] + below[j] + below[j + 1];
+    }
+    else
+    {
+        for (const auto& [offX, offY] : Offsets)
         {
-            AnalyzeStateChanges(cellChanges, i, j);
+            auto x = WrapCoordinate(i + offX, m_height, m_boundary);
+            auto y = WrapCoordinate(j + offY, m_width, m_boundary);
+            if (x >= 0 && y >= 0 && m_board[x][y])
+                nrAliveNeighbors++;
         }
     }
-
-    return cellChanges;
+    return m_rule.IsAliveNextGeneration(m_board[i][j], nrAliveNeighbors);
 }
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
+#include <Boundary.h>
+#include <Partitioning.h>
+#include <Rule.h>
 
 using StateChange = std::pair<int, int>;
 using StateChanges = std::vector<StateChange>;
@@ -9,13 +14,18 @@ using State = std::vector<std::vector<bool>>;
 class GameOfLife
 {
 public:
+    static constexpr int TileSize = 64;
+
     GameOfLife() = default;
     GameOfLife(const GameOfLife&) = delete;
     GameOfLife& operator=(const GameOfLife&) = delete;
     GameOfLife(GameOfLife&&) = delete;
     GameOfLife& operator=(GameOfLife&&) = delete;
 
+    // square board
     GameOfLife(int boardSize);
+    // height rows of width cells; cells are addressed as (row, column)
+    GameOfLife(int width, int height);
 
     void SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart);
     void SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart);
@@ -26,16 +36,49 @@ public:
     auto at(int x, int y);
 
     StateChanges GenNextStateChanges();
+    // Only re-evaluates the cells of previousChanges and their neighbours, the only cells that can flip
+    // after them. previousChanges must be the complete change list of the last generation.
+    StateChanges GenNextStateChanges(const StateChanges& previousChanges);
 
-    template<int compSize>
-    StateChanges GenNextStateChanges(int nrComp);
+    // Skips the tiles in which nothing could have changed since they were last evaluated.
+    StateChanges GenNextStateChanges(const Region& region);
     StateChanges GenNextStateChangesForRow(int row);
 
+    // Change lists of different regions can be applied concurrently as long as the region columns are
+    // split at multiples of TileSize: a row's vector<bool> words then never hold cells of two regions.
     void DoStateChanges(const std::vector<std::pair<int, int>>& cellChanges);
 
-    int BoardSize() const
+    // Writes the next generation into a second board and swaps the boards.
+    // The flipped cells are appended to cellChanges when it is given.
+    void Step(StateChanges* cellChanges = nullptr);
+
+    void SetRule(const Rule& rule)
+    {
+        m_rule = rule;
+        MarkAllTiles();
+    }
+    const Rule& GetRule() const
+    {
+        return m_rule;
+    }
+
+    void SetBoundary(Boundary boundary)
+    {
+        m_boundary = boundary;
+        MarkAllTiles();
+    }
+    Boundary GetBoundary() const
+    {
+        return m_boundary;
+    }
+
+    int Width() const
+    {
+        return m_width;
+    }
+    int Height() const
     {
-        return m_boardSize;
+        return m_height;
     }
     std::vector<bool>& operator[](int index)
     {
@@ -50,16 +93,23 @@ public:
 private:
 
     void AnalyzeStateChanges(StateChanges& stateChanges, int i, int j);
-
-    const int m_boardSize;
+    bool IsAliveNextGeneration(int i, int j);
+    void MarkTilesAround(int x, int y);
+    void MarkAllTiles();
+
+    const int m_width;
+    const int m_height;
+    Rule m_rule = ConwayLife;
+    Boundary m_boundary = Boundary::Dead;
     mutable State m_board;
+    State m_nextBoard;
+    State m_frontierMarks;
+
+    // One byte per TileSize x TileSize tile, set when a cell in or next to the tile changes and
+    // cleared once the tile is evaluated. Atomic because workers applying their own changes also
+    // mark the tiles of neighbouring regions; relaxed is enough since the barrier between the
+    // evaluate and apply phases orders the clears against the sets.
+    const int m_nrTileRows;
+    const int m_nrTileCols;
+    std::vector<std::atomic<std::uint8_t>> m_activeTiles;
 };
-
-template<>
-StateChanges GameOfLife::GenNextStateChanges<2>(int compIdx);
-
-template<>
-StateChanges GameOfLife::GenNextStateChanges<4>(int compIdx);
-
-template<>
-StateChanges GameOfLife::GenNextStateChanges<16>(int compIdx);
\ No newline at end of file
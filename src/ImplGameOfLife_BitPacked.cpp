@@ -0,0 +1,783 @@
+#include <ImplGameOfLife_BitPacked.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+
+GameOfLife_BitPacked::GameOfLife_BitPacked(int boardSize) :
+    GameOfLife_BitPacked(boardSize, boardSize)
+{
+}
+
+GameOfLife_BitPacked::GameOfLife_BitPacked(int width, int height) :
+    m_width(width),
+    m_height(height),
+    m_wordsPerRow((width + BitsPerWord - 1) / BitsPerWord),
+    m_rowStride(m_wordsPerRow + 2),
+    m_lastWordMask(width % BitsPerWord == 0 ? ~Word(0) : (Word(1) << (width % BitsPerWord)) - 1)
+{
+    SetIsa(BitKernels::DetectIsa());
+    m_board.assign(static_cast<std::size_t>(m_height + 2) * m_rowStride, 0); // ghost rows and words stay 0
+}
+
+void GameOfLife_BitPacked::SetIsa(BitKernels::Isa isa)
+{
+    if (isa > BitKernels::DetectIsa())
+        isa = BitKernels::DetectIsa();
+
+    m_isa = isa;
+    m_rowKernel = BitKernels::SelectRowKernel(isa, m_rule);
+}
+
+void GameOfLife_BitPacked::SetRule(const Rule& rule)
+{
+    m_rule = rule;
+    m_rowKernel = BitKernels::SelectRowKernel(m_isa, m_rule);
+    if (m_useLookupTable)
+        m_lookupTable = BitKernels::LookupTable(m_rule);
+    WriteFileHeader();
+}
+
+void GameOfLife_BitPacked::SetBoundary(Boundary boundary)
+{
+    m_boundary = boundary;
+    ClearHalo(m_board);
+    ClearHalo(m_nextBoard);
+    WriteFileHeader();
+}
+
+namespace
+{
+    constexpr char BoardFileMagic[8] = { 'G', 'O', 'L', 'B', 'O', 'A', 'R', 'D' };
+    constexpr std::uint32_t BoardFileVersion = 1;
+    constexpr std::size_t BoardFileHeaderBytes = 4096;  // keeps the boards page aligned
+
+    struct BoardFileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t headerBytes;
+        std::int32_t width;
+        std::int32_t height;
+        std::int32_t rowStride;
+        std::uint32_t currentBoard;
+        std::uint16_t birth;
+        std::uint16_t survival;
+        std::uint32_t boundary;
+    };
+
+    bool IsValidHeader(const BoardFileHeader& header, std::size_t fileSize)
+    {
+        if (std::memcmp(header.magic, BoardFileMagic, sizeof(BoardFileMagic)) != 0 || header.version != BoardFileVersion ||
+            header.headerBytes != BoardFileHeaderBytes || header.width <= 0 || header.height <= 0 || header.currentBoard > 1 ||
+            header.boundary > static_cast<std::uint32_t>(Boundary::Mirror))
+            return false;
+
+        // the layout the constructor gives a board of this width, in 64 bits so no field can overflow it
+        auto wordsPerRow = (static_cast<std::uint64_t>(header.width) + GameOfLife_BitPacked::BitsPerWord - 1) / GameOfLife_BitPacked::BitsPerWord;
+        if (static_cast<std::uint64_t>(header.rowStride) != wordsPerRow + 2)
+            return false;
+
+        auto boardWords = (static_cast<std::uint64_t>(header.height) + 2) * static_cast<std::uint64_t>(header.rowStride);
+        return fileSize == BoardFileHeaderBytes + 2 * boardWords * sizeof(Word);
+    }
+}
+
+bool GameOfLife_BitPacked::ReadBoardFileInfo(const std::string& path, BoardFileInfo& info)
+{
+    MappedFile file;
+    if (!file.Open(path, MappedFile::Access::ReadOnly) || file.Size() < BoardFileHeaderBytes)
+        return false;
+
+    const auto& header = *static_cast<const BoardFileHeader*>(file.Data());
+    if (!IsValidHeader(header, file.Size()))
+        return false;
+
+    info = BoardFileInfo{ header.width, header.height, Rule{ header.birth, header.survival }, static_cast<Boundary>(header.boundary) };
+    return true;
+}
+
+bool GameOfLife_BitPacked::MapToFile(const std::string& path)
+{
+    auto boardWords = m_board.size();
+    auto file = std::make_unique<MappedFile>();
+    if (!file->Create(path, BoardFileHeaderBytes + 2 * boardWords * sizeof(Word)))
+        return false;
+
+    auto* boards = reinterpret_cast<Word*>(static_cast<char*>(file->Data()) + BoardFileHeaderBytes);
+    std::copy_n(m_board.data(), boardWords, boards);
+    if (m_nextBoard.size() == boardWords)
+        std::copy_n(m_nextBoard.data(), boardWords, boards + boardWords);
+
+    m_file = std::move(file);
+    m_board.View(boards, boardWords);
+    m_nextBoard.View(boards + boardWords, boardWords);
+    WriteFileHeader();
+    return true;
+}
+
+bool GameOfLife_BitPacked::OpenMappedFile(const std::string& path)
+{
+    auto file = std::make_unique<MappedFile>();
+    if (!file->Open(path) || file->Size() < BoardFileHeaderBytes)
+        return false;
+
+    const auto& header = *static_cast<const BoardFileHeader*>(file->Data());
+    if (!IsValidHeader(header, file->Size()) || header.width != m_width || header.height != m_height || header.rowStride != m_rowStride)
+        return false;
+
+    auto boardWords = static_cast<std::size_t>(m_height + 2) * m_rowStride;
+    auto* boards = reinterpret_cast<Word*>(static_cast<char*>(file->Data()) + BoardFileHeaderBytes);
+    auto rule = Rule{ header.birth, header.survival };
+    auto boundary = static_cast<Boundary>(header.boundary);
+    auto current = header.currentBoard;
+
+    m_file = std::move(file);
+    m_board.View(boards + current * boardWords, boardWords);
+    m_nextBoard.View(boards + (1 - current) * boardWords, boardWords);
+    SetRule(rule);
+    m_boundary = boundary;
+    return true;
+}
+
+bool GameOfLife_BitPacked::SyncMappedFile()
+{
+    return m_file && m_file->Sync();
+}
+
+void GameOfLife_BitPacked::WriteFileHeader()
+{
+    if (!m_file)
+        return;
+
+    auto* boards = reinterpret_cast<Word*>(static_cast<char*>(m_file->Data()) + BoardFileHeaderBytes);
+    auto header = BoardFileHeader{};
+    std::memcpy(header.magic, BoardFileMagic, sizeof(BoardFileMagic));
+    header.version = BoardFileVersion;
+    header.headerBytes = BoardFileHeaderBytes;
+    header.width = m_width;
+    header.height = m_height;
+    header.rowStride = m_rowStride;
+    header.currentBoard = m_board.data() == boards ? 0 : 1;
+    header.birth = m_rule.birth;
+    header.survival = m_rule.survival;
+    header.boundary = static_cast<std::uint32_t>(m_boundary);
+    std::memcpy(m_file->Data(), &header, sizeof(header));
+}
+
+void GameOfLife_BitPacked::SwapBoards()
+{
+    m_board.swap(m_nextBoard);
+    WriteFileHeader();
+}
+
+void GameOfLife_BitPacked::ClearHalo(BoardBuffer& board)
+{
+    if (board.size() != m_board.size())
+        return;
+
+    std::fill_n(board.data(), m_rowStride, Word(0));
+    std::fill_n(board.data() + board.size() - m_rowStride, m_rowStride, Word(0));
+    for (int i = 0; i < m_height; i++)
+    {
+        auto* row = board.data() + (i + 1) * m_rowStride + 1;
+        row[-1] = 0;
+        row[m_wordsPerRow - 1] &= m_lastWordMask;
+        row[m_wordsPerRow] = 0;
+    }
+}
+
+void GameOfLife_BitPacked::RefreshRowHalo(Word* row)
+{
+    auto lastColumn = m_width - 1;
+    auto firstCell = row[0] & 1;
+    auto lastCell = (row[lastColumn / BitsPerWord] >> (lastColumn % BitsPerWord)) & 1;
+    auto westCell = m_boundary == Boundary::Torus ? lastCell : firstCell;
+    auto eastCell = m_boundary == Boundary::Torus ? firstCell : lastCell;
+
+    row[-1] = westCell << (BitsPerWord - 1);
+    if (m_width % BitsPerWord == 0)
+    {
+        row[m_wordsPerRow] = eastCell;
+    }
+    else
+    {
+        row[m_wordsPerRow - 1] = (row[m_wordsPerRow - 1] & m_lastWordMask) | eastCell << (m_width % BitsPerWord);
+        row[m_wordsPerRow] = 0;
+    }
+}
+
+void GameOfLife_BitPacked::RefreshHalo(int startRow, int endRow)
+{
+    if (m_boundary == Boundary::Dead)
+        return;
+
+    for (int i = std::max(startRow - 1, 0); i <= std::min(endRow, m_height - 1); i++)
+        RefreshRowHalo(Row(i));
+
+    // the ghost rows are copied with their ghost words, which gives the corners
+    if (startRow == 0)
+    {
+        auto source = m_boundary == Boundary::Torus ? m_height - 1 : 0;
+        RefreshRowHalo(Row(source));
+        std::copy_n(Row(source) - 1, m_rowStride, Row(-1) - 1);
+    }
+    if (endRow == m_height)
+    {
+        auto source = m_boundary == Boundary::Torus ? 0 : m_height - 1;
+        RefreshRowHalo(Row(source));
+        std::copy_n(Row(source) - 1, m_rowStride, Row(m_height) - 1);
+    }
+}
+
+void GameOfLife_BitPacked::SetUseLookupTable(bool useLookupTable)
+{
+    m_useLookupTable = useLookupTable;
+    if (m_useLookupTable)
+        m_lookupTable = BitKernels::LookupTable(m_rule);
+}
+
+void GameOfLife_BitPacked::InitBoardWithRandomData(unsigned seed)
+{
+    std::default_random_engine generator(seed);
+
+    std::uniform_int_distribution<int> distribution(0, 1);
+
+    for (int i = 0; i < m_height; ++i)
+    {
+        for (int j = 0; j < m_width; ++j)
+            SetCell(i, j, static_cast<bool>(distribution(generator)));
+    }
+}
+
+bool GameOfLife_BitPacked::GetCell(int x, int y) const
+{
+    return (Row(x)[y / BitsPerWord] >> (y % BitsPerWord)) & 1;
+}
+
+void GameOfLife_BitPacked::SetCell(int x, int y, bool alive)
+{
+    auto& word = Row(x)[y / BitsPerWord];
+    auto bit = Word(1) << (y % BitsPerWord);
+    word = alive ? word | bit : word & ~bit;
+}
+
+void GameOfLife_BitPacked::SetRow(int row, const Word* words)
+{
+    auto* destination = Row(row);
+    std::copy_n(words, m_wordsPerRow, destination);
+    destination[m_wordsPerRow - 1] &= m_lastWordMask;
+}
+
+void GameOfLife_BitPacked::SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart)
+{
+    for (const auto& [x, y] : aliveCellsAtStart)
+    {
+        SetCell(x, y, true);
+    }
+}
+
+void GameOfLife_BitPacked::SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart)
+{
+    if (static_cast<int>(aliveCellsAtStart.size()) != m_height || static_cast<int>(aliveCellsAtStart.front().size()) != m_width)
+        return;
+
+    for (int i = 0; i < m_height; i++)
+    {
+        for (int j = 0; j < m_width; j++)
+            SetCell(i, j, aliveCellsAtStart[i][j]);
+    }
+}
+
+State GameOfLife_BitPacked::GetState() const
+{
+    auto state = State(m_height, std::vector<bool>(m_width));
+    for (int i = 0; i < m_height; i++)
+    {
+        for (int j = 0; j < m_width; j++)
+            state[i][j] = GetCell(i, j);
+    }
+    return state;
+}
+
+void GameOfLife_BitPacked::GenNextRow(const Word* row, Word* nextRow, int firstWord, int lastWord) const
+{
+    m_rowKernel(row - m_rowStride, row, row + m_rowStride, nextRow, firstWord, lastWord, m_rule);
+    if (lastWord == m_wordsPerRow)
+        nextRow[m_wordsPerRow - 1] &= m_lastWordMask;
+}
+
+void GameOfLife_BitPacked::GenNextRowPair(const Word* row, Word* nextRow, Word* nextRowBelow, int firstWord, int lastWord) const
+{
+    if (!m_useLookupTable)
+    {
+        GenNextRow(row, nextRow, firstWord, lastWord);
+        GenNextRow(row + m_rowStride, nextRowBelow, firstWord, lastWord);
+        return;
+    }
+
+    BitKernels::StepRowPairLookup(row - m_rowStride, row, row + m_rowStride, row + 2 * m_rowStride, nextRow, nextRowBelow, firstWord, lastWord, m_lookupTable);
+    if (lastWord == m_wordsPerRow)
+    {
+        nextRow[m_wordsPerRow - 1] &= m_lastWordMask;
+        nextRowBelow[m_wordsPerRow - 1] &= m_lastWordMask;
+    }
+}
+
+void GameOfLife_BitPacked::GenNextRow(int row, Word* nextRow) const
+{
+    GenNextRow(Row(row), nextRow, 0, m_wordsPerRow);
+}
+
+void GameOfLife_BitPacked::GenNextRowPair(int row, Word* nextRow, Word* nextRowBelow) const
+{
+    if (row + 1 >= m_height)
+        GenNextRow(Row(row), nextRow, 0, m_wordsPerRow);
+    else
+        GenNextRowPair(Row(row), nextRow, nextRowBelow, 0, m_wordsPerRow);
+}
+
+void GameOfLife_BitPacked::AppendRowChanges(StateChanges& cellChanges, int row, const Word* nextRow) const
+{
+    const auto* current = Row(row);
+    for (int i = 0; i < m_wordsPerRow; i++)
+    {
+        auto flipped = current[i] ^ nextRow[i];
+        if (i == m_wordsPerRow - 1)
+            flipped &= m_lastWordMask;
+        while (flipped)
+        {
+            cellChanges.emplace_back(row, i * BitsPerWord + BitKernels::LowestBitIndex(flipped));
+            flipped &= flipped - 1;
+        }
+    }
+}
+
+StateChanges GameOfLife_BitPacked::GenNextStateChanges()
+{
+    RefreshHalo(0, m_height);
+    auto cellChanges = StateChanges();
+    auto nextRows = std::vector<Word>(2 * m_wordsPerRow);
+    auto* nextRow = nextRows.data();
+    auto* nextRowBelow = nextRow + m_wordsPerRow;
+
+    for (int i = 0; i < m_height; i += 2)
+    {
+        GenNextRowPair(i, nextRow, nextRowBelow);
+        AppendRowChanges(cellChanges, i, nextRow);
+        if (i + 1 < m_height)
+            AppendRowChanges(cellChanges, i + 1, nextRowBelow);
+    }
+
+    return cellChanges;
+}
+
+StateChanges GameOfLife_BitPacked::GenNextStateChangesForRow(int row)
+{
+    RefreshHalo(row, row + 1);
+    auto cellChanges = StateChanges();
+    auto nextRow = std::vector<Word>(m_wordsPerRow);
+
+    GenNextRow(row, nextRow.data());
+    AppendRowChanges(cellChanges, row, nextRow.data());
+
+    return cellChanges;
+}
+
+void GameOfLife_BitPacked::StepRows(int startRow, int endRow, StateChanges* cellChanges)
+{
+    for (int i = startRow; i < endRow; i += 2)
+    {
+        auto* nextRow = m_nextBoard.data() + (Row(i) - m_board.data());
+        auto* nextRowBelow = nextRow + m_rowStride;
+        GenNextRowPair(i, nextRow, nextRowBelow);
+        if (cellChanges)
+        {
+            AppendRowChanges(*cellChanges, i, nextRow);
+            if (i + 1 < m_height)
+                AppendRowChanges(*cellChanges, i + 1, nextRowBelow);
+        }
+    }
+}
+
+void GameOfLife_BitPacked::Step(StateChanges* cellChanges)
+{
+    if (m_nextBoard.size() != m_board.size())
+        m_nextBoard.assign(m_board.size(), 0);
+
+    RefreshHalo(0, m_height);
+    StepRows(0, m_height, cellChanges);
+
+    SwapBoards();
+}
+
+void GameOfLife_BitPacked::Step(ThreadPool& pool, StateChanges* cellChanges)
+{
+    if (m_nextBoard.size() != m_board.size())
+        m_nextBoard.assign(m_board.size(), 0);
+
+    RefreshHalo(0, m_height);
+    // a few bands per worker so that uneven bands balance out through stealing; even boundaries keep row pairs intact
+    auto nrBands = std::min(pool.NrThreads() * 4, (m_height + 1) / 2);
+    auto boundaries = SplitRange(m_height, nrBands, 2);
+    auto bandChanges = std::vector<StateChanges>(cellChanges ? nrBands : 0);
+    pool.ParallelFor(nrBands, [&](int band)
+    {
+        StepRows(boundaries[band], boundaries[band + 1], cellChanges ? &bandChanges[band] : nullptr);
+    });
+
+    for (const auto& changes : bandChanges)
+        cellChanges->insert(cellChanges->end(), changes.begin(), changes.end());
+
+    SwapBoards();
+}
+
+namespace
+{
+    // Rows of the local buffer a band is advanced in; with two buffers of this many rows
+    // still fitting in a 1 MiB L2 each pass over a band stays out of DRAM.
+    int BlockRows(int rowStride, int depth)
+    {
+        constexpr auto blockBytes = 1 << 20;
+        auto rows = blockBytes / static_cast<int>(2 * rowStride * sizeof(Word)) - 2 * depth;
+        return std::max(rows, 2 * depth) & ~1;
+    }
+}
+
+void GameOfLife_BitPacked::AdvanceBand(int startRow, int endRow, int generations)
+{
+    // the halo shrinks by a row on every side not at the board edge each generation, so
+    // after the last one exactly [startRow, endRow) is still valid
+    auto localStart = std::max(startRow - generations, 0);
+    auto localEnd = std::min(endRow + generations, m_height);
+    auto nrLocalRows = localEnd - localStart;
+    auto localSize = static_cast<std::size_t>(nrLocalRows + 2) * m_rowStride;
+
+    thread_local State_BitPacked buffers[2];
+    for (auto& buffer : buffers)
+    {
+        if (buffer.size() < localSize)
+            buffer.resize(localSize);
+    }
+    auto localRow = [&](int buffer, int row) { return buffers[buffer].data() + (row + 1) * m_rowStride + 1; };
+
+    // the buffers are reused across bands and boards, so their ghost rows and words are cleared here;
+    // the kernels never write them
+    for (int buffer = 0; buffer < 2; buffer++)
+    {
+        std::fill_n(localRow(buffer, -1) - 1, m_rowStride, Word(0));
+        std::fill_n(localRow(buffer, nrLocalRows) - 1, m_rowStride, Word(0));
+        for (int i = 0; i < nrLocalRows; i++)
+        {
+            localRow(buffer, i)[-1] = 0;
+            localRow(buffer, i)[m_wordsPerRow] = 0;
+        }
+    }
+    std::copy_n(Row(localStart) - 1, static_cast<std::size_t>(nrLocalRows) * m_rowStride, localRow(0, 0) - 1);
+
+    auto current = 0;
+    for (int generation = 1; generation <= generations; generation++)
+    {
+        auto first = localStart == 0 ? 0 : generation;
+        auto last = localEnd == m_height ? nrLocalRows : nrLocalRows - generation;
+        for (int i = first; i < last; i += 2)
+        {
+            if (i + 1 < last)
+                GenNextRowPair(localRow(current, i), localRow(1 - current, i), localRow(1 - current, i + 1), 0, m_wordsPerRow);
+            else
+                GenNextRow(localRow(current, i), localRow(1 - current, i), 0, m_wordsPerRow);
+        }
+        current = 1 - current;
+    }
+
+    auto* nextRows = m_nextBoard.data() + (Row(startRow) - m_board.data());
+    std::copy_n(localRow(current, startRow - localStart) - 1, static_cast<std::size_t>(endRow - startRow) * m_rowStride, nextRows - 1);
+}
+
+void GameOfLife_BitPacked::Advance(int generations, int depth)
+{
+    if (m_boundary != Boundary::Dead)
+    {
+        for (int generation = 0; generation < generations; generation++)
+            Step();
+        return;
+    }
+    if (m_nextBoard.size() != m_board.size())
+        m_nextBoard.assign(m_board.size(), 0);
+
+    depth = std::max(depth, 1);
+    auto blockRows = BlockRows(m_rowStride, depth);
+    for (int done = 0; done < generations; done += depth)
+    {
+        auto passGenerations = std::min(depth, generations - done);
+        for (int startRow = 0; startRow < m_height; startRow += blockRows)
+            AdvanceBand(startRow, std::min(startRow + blockRows, m_height), passGenerations);
+        SwapBoards();
+    }
+}
+
+void GameOfLife_BitPacked::Advance(ThreadPool& pool, int generations, int depth)
+{
+    if (m_boundary != Boundary::Dead)
+    {
+        for (int generation = 0; generation < generations; generation++)
+            Step(pool);
+        return;
+    }
+    if (m_nextBoard.size() != m_board.size())
+        m_nextBoard.assign(m_board.size(), 0);
+
+    depth = std::max(depth, 1);
+    auto blockRows = BlockRows(m_rowStride, depth);
+    auto nrBands = std::max((m_height + blockRows - 1) / blockRows, pool.NrThreads());
+    nrBands = std::max(std::min(nrBands, (m_height + 1) / 2), 1);
+    auto boundaries = SplitRange(m_height, nrBands, 2);
+    for (int done = 0; done < generations; done += depth)
+    {
+        auto passGenerations = std::min(depth, generations - done);
+        pool.ParallelFor(nrBands, [&](int band)
+        {
+            AdvanceBand(boundaries[band], boundaries[band + 1], passGenerations);
+        });
+        SwapBoards();
+    }
+}
+
+// Progress of an AdvanceDataflow run. Tile t has finished generation[t] generations; its cells
+// for generation g are in boards[g % 2]. A tile may compute its next generation once its 8
+// neighbours have caught up with it, which also guarantees that nobody still reads the buffer
+// half it overwrites: a neighbour can be at most one generation ahead.
+struct GameOfLife_BitPacked::DataflowSchedule
+{
+    std::vector<int> rowBoundaries;
+    std::vector<int> wordBoundaries;
+    int nrTileRows = 0;
+    int nrTileCols = 0;
+    int generations = 0;
+    int maxSkew = 1;
+    Word* boards[2] = {};
+
+    std::mutex mutex;
+    std::vector<int> generation;
+    std::vector<int> nrTilesAtGeneration;
+    int minGeneration = 0;
+    std::vector<bool> scheduled;
+    std::vector<bool> waitsForSkew;
+    std::vector<int> skewWaiters;
+
+    // Returns false when a neighbour is behind; true when the tile may be scheduled or is only
+    // held back by maxSkew, which ready then tells apart.
+    bool NeighboursReady(int tile, bool& ready) const
+    {
+        auto tileGeneration = generation[tile];
+        if (scheduled[tile] || tileGeneration >= generations)
+            return false;
+
+        auto tileRow = tile / nrTileCols;
+        auto tileCol = tile % nrTileCols;
+        for (int i = std::max(tileRow - 1, 0); i <= std::min(tileRow + 1, nrTileRows - 1); i++)
+        {
+            for (int j = std::max(tileCol - 1, 0); j <= std::min(tileCol + 1, nrTileCols - 1); j++)
+            {
+                if (generation[i * nrTileCols + j] < tileGeneration)
+                    return false;
+            }
+        }
+        ready = tileGeneration < minGeneration + maxSkew;
+        return true;
+    }
+};
+
+void GameOfLife_BitPacked::RunDataflowTile(DataflowSchedule& schedule, ThreadPool& pool, int tile)
+{
+    // the first tile made ready is run right here instead of going through the pool
+    while (tile >= 0)
+        tile = StepDataflowTile(schedule, pool, tile);
+}
+
+int GameOfLife_BitPacked::StepDataflowTile(DataflowSchedule& schedule, ThreadPool& pool, int tile)
+{
+    auto tileRow = tile / schedule.nrTileCols;
+    auto tileCol = tile % schedule.nrTileCols;
+    auto startRow = schedule.rowBoundaries[tileRow];
+    auto endRow = schedule.rowBoundaries[tileRow + 1];
+    auto firstWord = schedule.wordBoundaries[tileCol];
+    auto lastWord = schedule.wordBoundaries[tileCol + 1];
+
+    auto generation = schedule.generation[tile];
+    auto offset = Row(startRow) - m_board.data();
+    const auto* row = schedule.boards[generation % 2] + offset;
+    auto* nextRow = schedule.boards[(generation + 1) % 2] + offset;
+    for (int i = startRow; i < endRow; i += 2)
+    {
+        if (i + 1 < endRow)
+            GenNextRowPair(row, nextRow, nextRow + m_rowStride, firstWord, lastWord);
+        else
+            GenNextRow(row, nextRow, firstWord, lastWord);
+        row += 2 * m_rowStride;
+        nextRow += 2 * m_rowStride;
+    }
+
+    auto readyTiles = std::vector<int>();
+    {
+        std::lock_guard<std::mutex> lock(schedule.mutex);
+        schedule.generation[tile] = generation + 1;
+        schedule.scheduled[tile] = false;
+        schedule.nrTilesAtGeneration[generation]--;
+        schedule.nrTilesAtGeneration[generation + 1]++;
+
+        auto candidates = std::vector<int>();
+        auto tileRowEnd = std::min(tileRow + 1, schedule.nrTileRows - 1);
+        auto tileColEnd = std::min(tileCol + 1, schedule.nrTileCols - 1);
+        for (int i = std::max(tileRow - 1, 0); i <= tileRowEnd; i++)
+        {
+            for (int j = std::max(tileCol - 1, 0); j <= tileColEnd; j++)
+                candidates.push_back(i * schedule.nrTileCols + j);
+        }
+
+        if (schedule.nrTilesAtGeneration[schedule.minGeneration] == 0)
+        {
+            while (schedule.minGeneration < schedule.generations && schedule.nrTilesAtGeneration[schedule.minGeneration] == 0)
+                schedule.minGeneration++;
+            for (auto waiter : schedule.skewWaiters)
+            {
+                schedule.waitsForSkew[waiter] = false;
+                candidates.push_back(waiter);
+            }
+            schedule.skewWaiters.clear();
+        }
+
+        for (auto candidate : candidates)
+        {
+            auto ready = false;
+            if (!schedule.NeighboursReady(candidate, ready))
+                continue;
+
+            if (ready)
+            {
+                schedule.scheduled[candidate] = true;
+                readyTiles.push_back(candidate);
+            }
+            else if (!schedule.waitsForSkew[candidate])
+            {
+                schedule.waitsForSkew[candidate] = true;
+                schedule.skewWaiters.push_back(candidate);
+            }
+        }
+    }
+
+    for (std::size_t i = 1; i < readyTiles.size(); i++)
+    {
+        auto readyTile = readyTiles[i];
+        pool.Submit([this, &schedule, &pool, readyTile]() { RunDataflowTile(schedule, pool, readyTile); });
+    }
+    return readyTiles.empty() ? -1 : readyTiles.front();
+}
+
+void GameOfLife_BitPacked::AdvanceDataflow(ThreadPool& pool, int generations, int maxSkew)
+{
+    if (m_boundary != Boundary::Dead)
+    {
+        for (int generation = 0; generation < generations; generation++)
+            Step(pool);
+        return;
+    }
+    if (generations <= 0)
+        return;
+    if (m_nextBoard.size() != m_board.size())
+        m_nextBoard.assign(m_board.size(), 0);
+
+    constexpr auto tileRows = 32;
+    constexpr auto tileWords = 256;
+    auto schedule = DataflowSchedule();
+    schedule.nrTileRows = (m_height + tileRows - 1) / tileRows;
+    schedule.nrTileCols = (m_wordsPerRow + tileWords - 1) / tileWords;
+    schedule.rowBoundaries = SplitRange(m_height, schedule.nrTileRows, 2);
+    schedule.wordBoundaries = SplitRange(m_wordsPerRow, schedule.nrTileCols);
+    schedule.generations = generations;
+    schedule.maxSkew = std::max(maxSkew, 1);
+    schedule.boards[0] = m_board.data();
+    schedule.boards[1] = m_nextBoard.data();
+
+    auto nrTiles = schedule.nrTileRows * schedule.nrTileCols;
+    schedule.generation.assign(nrTiles, 0);
+    schedule.nrTilesAtGeneration.assign(generations + 1, 0);
+    schedule.nrTilesAtGeneration[0] = nrTiles;
+    schedule.scheduled.assign(nrTiles, true);
+    schedule.waitsForSkew.assign(nrTiles, false);
+
+    for (int tile = 0; tile < nrTiles; tile++)
+        pool.Submit([this, &schedule, &pool, tile]() { RunDataflowTile(schedule, pool, tile); });
+    pool.Wait();
+
+    if (generations % 2)
+        SwapBoards();
+}
+
+void GameOfLife_BitPacked::DoStateChanges(const std::vector<std::pair<int, int>>& cellChanges)
+{
+    for (const auto& cell : cellChanges)
+    {
+        ToggleCellState(cell);
+    }
+}
+
+void GameOfLife_BitPacked::ToggleCellState(const std::pair<int, int>& cell)
+{
+    Row(cell.first)[cell.second / BitsPerWord] ^= Word(1) << (cell.second % BitsPerWord);
+}
+
+std::size_t GameOfLife_BitPacked::Population() const
+{
+    auto population = std::size_t(0);
+    for (int i = 0; i < m_height; i++)
+    {
+        const auto* row = Row(i);
+        for (int j = 0; j < m_wordsPerRow - 1; j++)
+            population += BitKernels::PopCount(row[j]);
+        population += BitKernels::PopCount(row[m_wordsPerRow - 1] & m_lastWordMask);
+    }
+    return population;
+}
+
+bool GameOfLife_BitPacked::WritePackedRows(std::ostream& out) const
+{
+    auto rowBytes = static_cast<std::streamsize>(m_wordsPerRow * sizeof(Word));
+    for (int i = 0; i < m_height && out; i++)
+        out.write(reinterpret_cast<const char*>(Row(i)), rowBytes);
+    return static_cast<bool>(out);
+}
+
+bool GameOfLife_BitPacked::ReadPackedRows(std::istream& in)
+{
+    auto rowBytes = static_cast<std::streamsize>(m_wordsPerRow * sizeof(Word));
+    for (int i = 0; i < m_height; i++)
+    {
+        if (!in.read(reinterpret_cast<char*>(Row(i)), rowBytes))
+            return false;
+        Row(i)[m_wordsPerRow - 1] &= m_lastWordMask;
+    }
+    return true;
+}
+
+bool GameOfLife_BitPacked::WriteBoardState(std::ostream& out) const
+{
+    // whole lines at a time, a stream call per cell is what makes large dumps slow
+    auto line = std::string(static_cast<std::size_t>(m_width) + 1, '\n');
+    for (int i = 0; i < m_height && out; i++)
+    {
+        const auto* row = Row(i);
+        for (int j = 0; j < m_width; j++)
+            line[j] = (row[j / BitsPerWord] >> (j % BitsPerWord)) & 1 ? '1' : '0';
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+    out << "------------------------------------------\n";
+    return static_cast<bool>(out);
+}
+
+void GameOfLife_BitPacked::PrintBoardState()
+{
+    WriteBoardState(std::cout);
+}
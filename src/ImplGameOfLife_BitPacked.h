@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <BitKernels.h>
+#include <ImplGameOfLife.h>
+#include <MappedFile.h>
+#include <Partitioning.h>
+#include <ThreadPool.h>
+
+using State_BitPacked = std::vector<Word>;
+
+// Words of one generation: owned by the buffer, or a view into a mapped board file.
+class BoardBuffer
+{
+public:
+    Word* data()
+    {
+        return m_words;
+    }
+    const Word* data() const
+    {
+        return m_words;
+    }
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    // A view keeps its size and is only filled.
+    void assign(std::size_t size, Word value)
+    {
+        if (m_owned.empty() && m_words)
+        {
+            std::fill_n(m_words, m_size, value);
+            return;
+        }
+        m_owned.assign(size, value);
+        m_words = m_owned.data();
+        m_size = size;
+    }
+
+    void swap(BoardBuffer& other)
+    {
+        m_owned.swap(other.m_owned);
+        std::swap(m_words, other.m_words);
+        std::swap(m_size, other.m_size);
+    }
+
+    void View(Word* words, std::size_t size)
+    {
+        m_owned = State_BitPacked();
+        m_words = words;
+        m_size = size;
+    }
+
+private:
+    State_BitPacked m_owned;
+    Word* m_words = nullptr;
+    std::size_t m_size = 0;
+};
+
+// Board stored as rows of 64-cell words. Every row is padded with a ghost word on
+// each side and the board with a ghost row above and below, so the kernel can read
+// the neighbours of any word without bounds checks.
+class GameOfLife_BitPacked
+{
+public:
+    static constexpr int BitsPerWord = 64;
+
+    GameOfLife_BitPacked() = default;
+    GameOfLife_BitPacked(const GameOfLife_BitPacked&) = delete;
+    GameOfLife_BitPacked& operator=(const GameOfLife_BitPacked&) = delete;
+    GameOfLife_BitPacked(GameOfLife_BitPacked&&) = delete;
+    GameOfLife_BitPacked& operator=(GameOfLife_BitPacked&&) = delete;
+
+    GameOfLife_BitPacked(int boardSize);
+    GameOfLife_BitPacked(int width, int height);
+
+    void SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart);
+    void SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart);
+
+    State GetState() const;
+
+    bool GetCell(int x, int y) const;
+    void SetCell(int x, int y, bool alive);
+
+    StateChanges GenNextStateChanges();
+    StateChanges GenNextStateChangesForRow(int row);
+
+    void DoStateChanges(const std::vector<std::pair<int, int>>& cellChanges);
+
+    // Writes the next generation into the second buffer and swaps the buffers.
+    // The flipped cells are appended to cellChanges when it is given.
+    void Step(StateChanges* cellChanges = nullptr);
+    // Same as Step, with row bands computed on the pool's workers.
+    void Step(ThreadPool& pool, StateChanges* cellChanges = nullptr);
+
+    // Temporal blocking: each row band is copied with a depth-row halo into a cache-sized
+    // buffer and advanced up to depth generations there before it is written back, so the
+    // board goes through memory once per depth generations instead of once per generation.
+    // The halo rows are recomputed by both neighbouring bands.
+    void Advance(int generations, int depth);
+    void Advance(ThreadPool& pool, int generations, int depth);
+
+    // Advances 32-row by 16384-column tiles as soon as they and their 8 neighbours have finished the
+    // previous generation, so there is no barrier between generations. No tile gets more than
+    // maxSkew generations ahead of the slowest one; maxSkew 1 behaves like a barrier.
+    void AdvanceDataflow(ThreadPool& pool, int generations, int maxSkew);
+
+    // Kernels above what the CPU supports fall back to the best supported one.
+    void SetIsa(BitKernels::Isa isa);
+    BitKernels::Isa GetIsa() const
+    {
+        return m_isa;
+    }
+
+    void SetRule(const Rule& rule);
+    const Rule& GetRule() const
+    {
+        return m_rule;
+    }
+
+    // Torus and mirror are realized by refreshing the ghost words and rows from the board before
+    // each generation, so the kernels stay free of bounds checks. Advance and AdvanceDataflow
+    // step generation by generation for them.
+    void SetBoundary(Boundary boundary);
+    Boundary GetBoundary() const
+    {
+        return m_boundary;
+    }
+
+    // A board file is a 4 KiB header followed by both generation buffers in the in-memory layout,
+    // ghost words and rows included, so a mapped board is stepped in place and reopened without
+    // a parse step; the OS pages it in and out. The header records the dimensions, rule, boundary
+    // and which buffer holds the current generation.
+    struct BoardFileInfo
+    {
+        int width;
+        int height;
+        Rule rule;
+        Boundary boundary;
+    };
+    static bool ReadBoardFileInfo(const std::string& path, BoardFileInfo& info);
+    // Copies the board into a new file at path and steps it there from now on.
+    bool MapToFile(const std::string& path);
+    // Continues from a board file; its dimensions must match this board's.
+    bool OpenMappedFile(const std::string& path);
+    // Blocks until the mapped board is on disk. Without it the OS writes it back in its own time.
+    bool SyncMappedFile();
+    bool IsMapped() const
+    {
+        return m_file != nullptr;
+    }
+
+    // Evaluates the rule through BitKernels::LookupTable(), two rows per pass, instead of the row kernel.
+    void SetUseLookupTable(bool useLookupTable);
+    bool UsesLookupTable() const
+    {
+        return m_useLookupTable;
+    }
+
+    int Width() const
+    {
+        return m_width;
+    }
+    int Height() const
+    {
+        return m_height;
+    }
+    int WordsPerRow() const
+    {
+        return m_wordsPerRow;
+    }
+
+    // WordsPerRow() words of the row. The bits past the width of the last word are not cells and
+    // are ignored by SetRow.
+    const Word* GetRow(int row) const
+    {
+        return Row(row);
+    }
+    void SetRow(int row, const Word* words);
+
+    void ToggleCellState(const std::pair<int, int>& cell);
+
+    std::size_t Population() const;
+
+    // Height() rows of WordsPerRow() words each, without ghost words, in the machine's byte order.
+    bool WritePackedRows(std::ostream& out) const;
+    bool ReadPackedRows(std::istream& in);
+
+    // Frame dump in the text format of PrintBoardState, a line per row.
+    bool WriteBoardState(std::ostream& out) const;
+    void PrintBoardState();
+    void InitBoardWithRandomData(unsigned seed);
+
+private:
+    Word* Row(int row)
+    {
+        return m_board.data() + (row + 1) * m_rowStride + 1;
+    }
+    const Word* Row(int row) const
+    {
+        return m_board.data() + (row + 1) * m_rowStride + 1;
+    }
+
+    // row points into a buffer laid out like m_board, whose neighbouring rows are m_rowStride apart;
+    // only words [firstWord, lastWord) of the next rows are written
+    void GenNextRow(const Word* row, Word* nextRow, int firstWord, int lastWord) const;
+    void GenNextRowPair(const Word* row, Word* nextRow, Word* nextRowBelow, int firstWord, int lastWord) const;
+    void GenNextRow(int row, Word* nextRow) const;
+    // nextRowBelow is not written when row is the last row
+    void GenNextRowPair(int row, Word* nextRow, Word* nextRowBelow) const;
+    // Writes rows [startRow, endRow) of the next generation into m_nextBoard.
+    void StepRows(int startRow, int endRow, StateChanges* cellChanges);
+    // Writes rows [startRow, endRow), generations ahead, into m_nextBoard.
+    void AdvanceBand(int startRow, int endRow, int generations);
+    struct DataflowSchedule;
+    void RunDataflowTile(DataflowSchedule& schedule, ThreadPool& pool, int tile);
+    // Advances the tile one generation; returns one of the tiles that became ready, or -1.
+    int StepDataflowTile(DataflowSchedule& schedule, ThreadPool& pool, int tile);
+    void AppendRowChanges(StateChanges& cellChanges, int row, const Word* nextRow) const;
+    // Fills the ghost words of rows [startRow - 1, endRow] and, when the range touches the top or
+    // bottom, the ghost rows according to m_boundary. For a width that is not a multiple of 64 the
+    // cell east of the last column goes into the first unused bit of the last word, which is why
+    // readers of whole words mask that word.
+    void RefreshHalo(int startRow, int endRow);
+    void RefreshRowHalo(Word* row);
+    void ClearHalo(BoardBuffer& board);
+    // Swaps the generation buffers; a mapped file's header follows.
+    void SwapBoards();
+    void WriteFileHeader();
+
+    const int m_width;
+    const int m_height;
+    const int m_wordsPerRow;
+    const int m_rowStride;
+    const Word m_lastWordMask;
+    Rule m_rule = ConwayLife;
+    Boundary m_boundary = Boundary::Dead;
+    BitKernels::Isa m_isa = BitKernels::Isa::Scalar;
+    BitKernels::RowKernel m_rowKernel = nullptr;
+    bool m_useLookupTable = false;
+    const std::uint8_t* m_lookupTable = nullptr;
+    std::unique_ptr<MappedFile> m_file;
+    BoardBuffer m_board;
+    BoardBuffer m_nextBoard;
+};
@@ -18,21 +18,20 @@ namespace
             { 1, 1 },
         }
     };
+}
 
-    auto CoordsInBoardSize(int boardSize, int x, int y)
-    {
-        return !(x < 0 || y < 0 || x >= boardSize || y >= boardSize);
-    }
+GameOfLife_Contiguous::GameOfLife_Contiguous(int boardSize) :GameOfLife_Contiguous(boardSize, boardSize)
+{
 }
 
-GameOfLife_Contiguous::GameOfLife_Contiguous(int boardSize) :m_boardSize(boardSize)
+GameOfLife_Contiguous::GameOfLife_Contiguous(int width, int height) :m_width(width), m_height(height)
 {
-    m_board.resize(m_boardSize * m_boardSize); // set num values
+    m_board.resize(static_cast<std::size_t>(m_width) * m_height); // set num values
 }
 
 auto GameOfLife_Contiguous::at(int x, int y)
 {
-    return m_board.at(x * m_boardSize + y);
+    return m_board.at(static_cast<std::size_t>(x) * m_width + y);
 }
 
 void GameOfLife_Contiguous::SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart)
@@ -78,9 +77,9 @@ StateChanges GameOfLife_Contiguous::GenNextStateChanges()
 {
     auto cellChanges = StateChanges();
 
-    for (int i = 0; i < m_boardSize; i++)
+    for (int i = 0; i < m_height; i++)
     {
-        for (int j = 0; j < m_boardSize; j++)
+        for (int j = 0; j < m_width; j++)
         {
             AnalyzeStateChanges(cellChanges, i, j);
         }
@@ -97,11 +96,26 @@ namespace
     }
 }
 
+StateChanges GameOfLife_Contiguous::GenNextStateChanges(const Region& region)
+{
+    auto cellChanges = StateChanges();
+
+    for (auto i = region.startRow; i < region.endRow; i++)
+    {
+        for (auto j = region.startCol; j < region.endCol; j++)
+        {
+            AnalyzeStateChanges(cellChanges, i, j);
+        }
+    }
+
+    return cellChanges;
+}
+
 StateChanges GameOfLife_Contiguous::GenNextStateChangesForRow(int row)
 {
     auto cellChanges = StateChanges();
 
-    for (int j = 0; j < m_boardSize; j++)
+    for (int j = 0; j < m_width; j++)
     {
         AnalyzeStateChanges(cellChanges, row, j);
     }
@@ -120,9 +134,9 @@ void GameOfLife_Contiguous::DoStateChanges(const std::vector<std::pair<int, int>
 
 void GameOfLife_Contiguous::PrintBoardState()
 {
-    for (int i = 0; i < m_boardSize; i++)
+    for (int i = 0; i < m_height; i++)
     {
-        for (int j = 0; j < m_boardSize; j++)
+        for (int j = 0; j < m_width; j++)
         {
             std::cout << at(i, j);
         }
@@ -138,108 +152,26 @@ void GameOfLife_Contiguous::ToggleCellState(const std::pair<int, int>& cell)
 
 void GameOfLife_Contiguous::AnalyzeStateChanges(StateChanges& cellChanges, int i, int j)
 {
-
     auto nrAliveNeighbors = 0;
-    auto nrDeadNeighbors = 0;
-    for (const auto& [offX, offY] : Offsets)
-    {
-        if (!CoordsInBoardSize(m_boardSize, i + offX, j + offY))
-            continue;
-
-        if (at(i + offX, j + offY))
-            nrAliveNeighbors++;
-        else
-            nrDeadNeighbors++;
-    }
-    if (at(i, j)) // cell is alive
-    {
-        if (nrAliveNeighbors <= 1) // if 0 or 1 alive neighbors, the cell dies by solitude
-            cellChanges.emplace_back(i, j);
-        else if (nrAliveNeighbors >= 4) // if 4 or more alive neighbors, the cell dies by overpopulation
-            cellChanges.emplace_back(i, j);
-    }
-    else                // cell is dead
-    {
-        if (nrAliveNeighbors == 3)
-            cellChanges.emplace_back(i, j);
+    auto index = static_cast<std::size_t>(i) * m_width + j;
+    if (i > 0 && j > 0 && i < m_height - 1 && j < m_width - 1)
+    {
+        // inner cells, all neighbours are on the board
+        auto above = index - m_width;
+        auto below = index + m_width;
+        nrAliveNeighbors = m_board[above - 1] + m_board[above] + m_board[above + 1] + m_board[index - 1] + m_board[index + 1] +
+            m_board[below - 1] + m_board[below] + m_board[below + 1];
     }
-}
-
-template<>
-StateChanges GameOfLife_Contiguous::GenNextStateChanges<2>(int compIdx)
-{
-    auto comps = 2;
-    auto compSize = m_boardSize / comps;
-
-    auto cellChanges = StateChanges();
-    cellChanges.reserve(compSize);
-    for (int i = compIdx * compSize; i < (compIdx + 1) * compSize; i++)
+    else
     {
-        for (int j = 0; j < m_boardSize; j++)
+        for (const auto& [offX, offY] : Offsets)
         {
-            AnalyzeStateChanges(cellChanges, i, j);
+            auto x = WrapCoordinate(i + offX, m_height, m_boundary);
+            auto y = WrapCoordinate(j + offY, m_width, m_boundary);
+            if (x >= 0 && y >= 0 && m_board[static_cast<std::size_t>(x) * m_width + y])
+                nrAliveNeighbors++;
         }
     }
-
-    return cellChanges;
-}
-
-template<>
-StateChanges GameOfLife_Contiguous::GenNextStateChanges<4>(int compIdx)
-{
-    auto comps = 4;
-    auto valsPerComp = comps / 2;
-
-    auto compSize = m_boardSize / valsPerComp;
-
-    auto rowIdx = compIdx / valsPerComp;
-    auto colIdx = compIdx % valsPerComp;
-
-    auto startRowIdx = rowIdx * compSize;
-    auto endRowIdx = rowIdx == 0 ? (rowIdx + 1) * compSize : m_boardSize;
-
-    auto startColIdx = colIdx * compSize;
-    auto endColIdx = colIdx == 0 ? (colIdx + 1) * compSize : m_boardSize;
-
-    auto cellChanges = StateChanges();
-    cellChanges.reserve(compSize);
-    for (auto i = startRowIdx; i < endRowIdx; i++)
-    {
-        for (auto j = startColIdx; j < endColIdx; j++)
-        {
-            AnalyzeStateChanges(cellChanges, i, j);
-        }
-    }
-
-    return cellChanges;
-}
-
-template<>
-StateChanges GameOfLife_Contiguous::GenNextStateChanges<16>(int compIdx)
-{
-    auto comps = 16;
-    auto valsPerComp = comps / 4;
-
-    auto compSize = m_boardSize / valsPerComp;
-
-    auto rowIdx = compIdx / valsPerComp;
-    auto colIdx = compIdx % valsPerComp;
-
-    auto startRowIdx = rowIdx * compSize;
-    auto endRowIdx = rowIdx != (valsPerComp - 1) ? (rowIdx + 1) * compSize : m_boardSize;
-
-    auto startColIdx = colIdx * compSize;
-    auto endColIdx = colIdx != (valsPerComp - 1) ? (colIdx + 1) * compSize : m_boardSize;
-
-    auto cellChanges = StateChanges();
-    cellChanges.reserve(compSize);
-    for (auto i = startRowIdx; i < endRowIdx; i++)
-    {
-        for (auto j = startColIdx; j < endColIdx; j++)
-        {
-            AnalyzeStateChanges(cellChanges, i, j);
-        }
-    }
-
-    return cellChanges;
+    if (m_rule.IsAliveNextGeneration(m_board[index], nrAliveNeighbors) != m_board[index])
+        cellChanges.emplace_back(i, j);
 }
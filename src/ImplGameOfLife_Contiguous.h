@@ -15,6 +15,7 @@ public:
     GameOfLife_Contiguous& operator=(GameOfLife_Contiguous&&) = delete;
 
     GameOfLife_Contiguous(int boardSize);
+    GameOfLife_Contiguous(int width, int height);
 
     void SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart);
     void SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart);
@@ -25,16 +26,37 @@ public:
     auto at(int x, int y);
 
     StateChanges GenNextStateChanges();
+    StateChanges GenNextStateChanges(const Region& region);
 
-    template<int compSize>
-    StateChanges GenNextStateChanges(int nrComp);
     StateChanges GenNextStateChangesForRow(int row);
 
     void DoStateChanges(const std::vector<std::pair<int, int>>& cellChanges);
 
-    int BoardSize() const
+    void SetRule(const Rule& rule)
     {
-        return m_boardSize;
+        m_rule = rule;
+    }
+    const Rule& GetRule() const
+    {
+        return m_rule;
+    }
+
+    void SetBoundary(Boundary boundary)
+    {
+        m_boundary = boundary;
+    }
+    Boundary GetBoundary() const
+    {
+        return m_boundary;
+    }
+
+    int Width() const
+    {
+        return m_width;
+    }
+    int Height() const
+    {
+        return m_height;
     }
 
     void ToggleCellState(const std::pair<int, int>& cell);
@@ -44,15 +66,9 @@ private:
 
     void AnalyzeStateChanges(StateChanges& stateChanges, int i, int j);
 
-    const int m_boardSize;
+    const int m_width;
+    const int m_height;
+    Rule m_rule = ConwayLife;
+    Boundary m_boundary = Boundary::Dead;
     mutable State_Contiguous m_board;
 };
-
-template<>
-StateChanges GameOfLife_Contiguous::GenNextStateChanges<2>(int compIdx);
-
-template<>
-StateChanges GameOfLife_Contiguous::GenNextStateChanges<4>(int compIdx);
-
-template<>
-StateChanges GameOfLife_Contiguous::GenNextStateChanges<16>(int compIdx);
\ No newline at end of file
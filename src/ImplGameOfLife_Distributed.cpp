@@ -0,0 +1,258 @@
+#include <ImplGameOfLife_Distributed.h>
+
+#include <algorithm>
+#include <Partitioning.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GOL_POSIX 1
+#include <csignal>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    bool ReportsStats(int generation, int generations, int statsInterval)
+    {
+        return generation == generations || (statsInterval > 0 && generation % statsInterval == 0);
+    }
+}
+
+GameOfLife_Distributed::GameOfLife_Distributed(int width, int height, int nrWorkers, HaloTransport transport) :
+    m_nrWorkers(std::max(std::min(nrWorkers, height), 1)),
+    m_transport(transport),
+    m_bandBoundaries(SplitRange(height, m_nrWorkers)),
+    m_board(width, height)
+{
+}
+
+bool GameOfLife_Distributed::IsSupported()
+{
+#if GOL_POSIX
+    return true;
+#else
+    return false;
+#endif
+}
+
+void GameOfLife_Distributed::SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart)
+{
+    m_board.SetInitialState(aliveCellsAtStart);
+}
+
+void GameOfLife_Distributed::SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart)
+{
+    m_board.SetInitialState(aliveCellsAtStart);
+}
+
+State GameOfLife_Distributed::GetState() const
+{
+    return m_board.GetState();
+}
+
+void GameOfLife_Distributed::SetRule(const Rule& rule)
+{
+    m_board.SetRule(rule);
+}
+
+bool GameOfLife_Distributed::RunWorker(int band, HaloLink* above, HaloLink* below, HaloLink& coordinator, int generations, int statsInterval) const
+{
+    auto startRow = m_bandBoundaries[band];
+    auto nrRows = m_bandBoundaries[band + 1] - startRow;
+    auto wordsPerRow = m_board.WordsPerRow();
+    auto rowBytes = static_cast<std::size_t>(wordsPerRow) * sizeof(Word);
+
+    // local row 0 and nrRows + 1 are the halo rows, recomputed as garbage by every Step and
+    // overwritten before the next one
+    GameOfLife_BitPacked local(m_board.Width(), nrRows + 2);
+    local.SetRule(m_board.GetRule());
+    local.SetIsa(m_board.GetIsa());
+    for (int i = 0; i < nrRows; i++)
+        local.SetRow(i + 1, m_board.GetRow(startRow + i));
+
+    auto halo = std::vector<Word>(wordsPerRow);
+    const auto zeros = std::vector<Word>(wordsPerRow);
+
+    // On every link the upper band sends first and the lower band receives first, and even bands
+    // serve their link below before the one above while odd bands do the opposite, so all links
+    // of one parity are busy at the same time and a row larger than the transport's buffer
+    // cannot deadlock the chain.
+    auto exchangeAbove = [&]()
+    {
+        if (!above)
+        {
+            local.SetRow(0, zeros.data());
+            return true;
+        }
+        if (!above->Receive(halo.data(), rowBytes) || !above->Send(local.GetRow(1), rowBytes))
+            return false;
+        local.SetRow(0, halo.data());
+        return true;
+    };
+    auto exchangeBelow = [&]()
+    {
+        if (!below)
+        {
+            local.SetRow(nrRows + 1, zeros.data());
+            return true;
+        }
+        if (!below->Send(local.GetRow(nrRows), rowBytes) || !below->Receive(halo.data(), rowBytes))
+            return false;
+        local.SetRow(nrRows + 1, halo.data());
+        return true;
+    };
+
+    for (int generation = 1; generation <= generations; generation++)
+    {
+        auto exchanged = band % 2 == 0 ? exchangeBelow() && exchangeAbove() : exchangeAbove() && exchangeBelow();
+        if (!exchanged)
+            return false;
+
+        local.Step();
+
+        if (ReportsStats(generation, generations, statsInterval))
+        {
+            auto stats = GenerationStats{ m_generation + generation, 0 };
+            for (int i = 1; i <= nrRows; i++)
+            {
+                const auto* row = local.GetRow(i);
+                for (int word = 0; word < wordsPerRow; word++)
+                    stats.population += BitKernels::PopCount(row[word]);
+            }
+            if (!coordinator.Send(&stats, sizeof(stats)))
+                return false;
+        }
+    }
+
+    for (int i = 1; i <= nrRows; i++)
+    {
+        if (!coordinator.Send(local.GetRow(i), rowBytes))
+            return false;
+    }
+    return true;
+}
+
+#if GOL_POSIX
+bool GameOfLife_Distributed::Advance(int generations, int statsInterval)
+{
+    if (generations <= 0)
+        return generations == 0;
+
+    // neighborLinks[i] joins band i (first) and band i + 1 (second)
+    auto neighborLinks = std::vector<HaloLinkPair>();
+    auto coordinatorLinks = std::vector<HaloLinkPair>();
+    for (int band = 0; band < m_nrWorkers; band++)
+    {
+        if (band > 0)
+            neighborLinks.push_back(CreateLinkPair(m_transport));
+        coordinatorLinks.push_back(CreateLinkPair(m_transport));
+        if (!coordinatorLinks.back().first || (band > 0 && !neighborLinks.back().first))
+            return false;
+    }
+
+    auto closeAll = [&]()
+    {
+        for (auto& links : { &neighborLinks, &coordinatorLinks })
+        {
+            for (auto& [first, second] : *links)
+            {
+                first->Close();
+                second->Close();
+            }
+        }
+    };
+
+    auto workers = std::vector<pid_t>();
+    for (int band = 0; band < m_nrWorkers; band++)
+    {
+        auto pid = ::fork();
+        if (pid == 0)
+        {
+            auto* above = band > 0 ? neighborLinks[band - 1].second.release() : nullptr;
+            auto* below = band + 1 < m_nrWorkers ? neighborLinks[band].first.release() : nullptr;
+            auto* coordinator = coordinatorLinks[band].second.release();
+            for (auto& links : { &neighborLinks, &coordinatorLinks })
+            {
+                for (auto& [first, second] : *links)
+                {
+                    if (first)
+                        first->Close();
+                    if (second)
+                        second->Close();
+                }
+            }
+            // _exit skips the destructors and atexit handlers, which belong to the coordinator
+            ::_exit(RunWorker(band, above, below, *coordinator, generations, statsInterval) ? 0 : 1);
+        }
+
+        if (pid < 0)
+        {
+            for (auto worker : workers)
+                ::kill(worker, SIGKILL);
+            for (auto worker : workers)
+                ::waitpid(worker, nullptr, 0);
+            closeAll();
+            return false;
+        }
+        workers.push_back(pid);
+    }
+
+    // with the workers' ends closed here, a receive fails when a worker dies instead of blocking
+    for (auto& [first, second] : neighborLinks)
+    {
+        first->Close();
+        second->Close();
+    }
+    for (auto& links : coordinatorLinks)
+        links.second->Close();
+
+    auto ok = true;
+    auto stats = std::vector<GenerationStats>();
+    for (int generation = 1; ok && generation <= generations; generation++)
+    {
+        if (!ReportsStats(generation, generations, statsInterval))
+            continue;
+
+        auto global = GenerationStats{ m_generation + generation, 0 };
+        for (int band = 0; ok && band < m_nrWorkers; band++)
+        {
+            auto bandStats = GenerationStats{};
+            ok = coordinatorLinks[band].first->Receive(&bandStats, sizeof(bandStats));
+            global.population += bandStats.population;
+        }
+        stats.push_back(global);
+    }
+
+    // received into a copy so that a failing worker leaves the board as it was
+    auto rows = std::vector<Word>(static_cast<std::size_t>(Height()) * m_board.WordsPerRow());
+    auto rowBytes = static_cast<std::size_t>(m_board.WordsPerRow()) * sizeof(Word);
+    for (int band = 0; ok && band < m_nrWorkers; band++)
+    {
+        for (int row = m_bandBoundaries[band]; ok && row < m_bandBoundaries[band + 1]; row++)
+            ok = coordinatorLinks[band].first->Receive(rows.data() + static_cast<std::size_t>(row) * m_board.WordsPerRow(), rowBytes);
+    }
+
+    for (auto worker : workers)
+    {
+        if (!ok)
+            ::kill(worker, SIGKILL);
+        auto status = 0;
+        ok = ::waitpid(worker, &status, 0) == worker && WIFEXITED(status) && WEXITSTATUS(status) == 0 && ok;
+    }
+    closeAll();
+    if (!ok)
+        return false;
+
+    for (int row = 0; row < Height(); row++)
+        m_board.SetRow(row, rows.data() + static_cast<std::size_t>(row) * m_board.WordsPerRow());
+    m_stats = std::move(stats);
+    m_generation += generations;
+    return true;
+}
+#else
+bool GameOfLife_Distributed::Advance(int generations, int)
+{
+    return generations == 0;
+}
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <HaloTransport.h>
+#include <ImplGameOfLife_BitPacked.h>
+
+// Domain decomposition over processes: the board is split into row bands, each advanced by a
+// forked worker process on a bit-packed board with one halo row above and below. Before every
+// generation neighbouring workers swap their edge rows over a HaloLink, and every statsInterval
+// generations each worker reports its population to the coordinator, which sums them. When a run
+// ends the workers send their bands back and exit, so between runs the board lives here.
+// Workers only need a HaloLink to reach each other, so another transport can be plugged in
+// without touching the stepping. Only available on POSIX systems, and only with dead boundaries.
+class GameOfLife_Distributed
+{
+public:
+    struct GenerationStats
+    {
+        std::uint64_t generation;
+        std::uint64_t population;
+    };
+
+    GameOfLife_Distributed(int width, int height, int nrWorkers, HaloTransport transport = HaloTransport::SharedMemory);
+    GameOfLife_Distributed(const GameOfLife_Distributed&) = delete;
+    GameOfLife_Distributed& operator=(const GameOfLife_Distributed&) = delete;
+    GameOfLife_Distributed(GameOfLife_Distributed&&) = delete;
+    GameOfLife_Distributed& operator=(GameOfLife_Distributed&&) = delete;
+
+    static bool IsSupported();
+
+    void SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart);
+    void SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart);
+
+    State GetState() const;
+
+    void SetRule(const Rule& rule);
+    const Rule& GetRule() const
+    {
+        return m_board.GetRule();
+    }
+
+    // Runs generations in the worker processes. Global stats are gathered after every
+    // statsInterval generations and after the last one; they replace Stats(). Returns false, with
+    // the board unchanged, when the links or processes could not be set up or a worker failed.
+    bool Advance(int generations, int statsInterval = 1);
+
+    const std::vector<GenerationStats>& Stats() const
+    {
+        return m_stats;
+    }
+    std::uint64_t Generation() const
+    {
+        return m_generation;
+    }
+
+    int Width() const
+    {
+        return m_board.Width();
+    }
+    int Height() const
+    {
+        return m_board.Height();
+    }
+    int NrWorkers() const
+    {
+        return m_nrWorkers;
+    }
+    HaloTransport Transport() const
+    {
+        return m_transport;
+    }
+
+private:
+    // Body of worker process band. above and below are null at the top and bottom of the board.
+    bool RunWorker(int band, HaloLink* above, HaloLink* below, HaloLink& coordinator, int generations, int statsInterval) const;
+
+    const int m_nrWorkers;
+    const HaloTransport m_transport;
+    const std::vector<int> m_bandBoundaries;
+    GameOfLife_BitPacked m_board;
+    std::vector<GenerationStats> m_stats;
+    std::uint64_t m_generation = 0;
+};
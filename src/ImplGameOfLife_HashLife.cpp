@@ -0,0 +1,330 @@
+#include <ImplGameOfLife_HashLife.h>
+
+#include <algorithm>
+#include <BitKernels.h>
+
+namespace
+{
+    using Node = GameOfLife_HashLife::Node;
+
+    void Rasterize(const Node* node, std::int64_t nodeX, std::int64_t nodeY, State& state, std::int64_t x, std::int64_t y)
+    {
+        if (node->population == 0)
+            return;
+
+        auto size = std::int64_t(1) << node->level;
+        auto nrRows = static_cast<std::int64_t>(state.size());
+        auto nrCols = nrRows ? static_cast<std::int64_t>(state.front().size()) : 0;
+        if (nodeX + size <= x || nodeY + size <= y || nodeX >= x + nrRows || nodeY >= y + nrCols)
+            return;
+
+        if (node->level == 0)
+        {
+            state[nodeX - x][nodeY - y] = true;
+            return;
+        }
+
+        auto half = size / 2;
+        Rasterize(node->nw, nodeX, nodeY, state, x, y);
+        Rasterize(node->ne, nodeX, nodeY + half, state, x, y);
+        Rasterize(node->sw, nodeX + half, nodeY, state, x, y);
+        Rasterize(node->se, nodeX + half, nodeY + half, state, x, y);
+    }
+}
+
+std::size_t GameOfLife_HashLife::NodeKeyHash::operator()(const NodeKey& key) const
+{
+    auto hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key.nw));
+    hash = hash * 0x9E3779B97F4A7C15ull + reinterpret_cast<std::uintptr_t>(key.ne);
+    hash = hash * 0x9E3779B97F4A7C15ull + reinterpret_cast<std::uintptr_t>(key.sw);
+    hash = hash * 0x9E3779B97F4A7C15ull + reinterpret_cast<std::uintptr_t>(key.se);
+    return static_cast<std::size_t>(hash ^ (hash >> 29));
+}
+
+GameOfLife_HashLife::GameOfLife_HashLife() :
+    m_deadLeaf{ nullptr, nullptr, nullptr, nullptr, 0, 0, nullptr, -1 },
+    m_aliveLeaf{ nullptr, nullptr, nullptr, nullptr, 0, 1, nullptr, -1 }
+{
+    m_lookupTable = BitKernels::LookupTable(m_rule);
+    m_root = EmptyNode(3);
+}
+
+void GameOfLife_HashLife::SetRule(const Rule& rule)
+{
+    m_rule = rule;
+    m_lookupTable = BitKernels::LookupTable(m_rule);
+    CollectGarbage();
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::Join(const Node* nw, const Node* ne, const Node* sw, const Node* se)
+{
+    auto key = NodeKey{ nw, ne, sw, se };
+    auto found = m_table.find(key);
+    if (found != m_table.end())
+        return found->second;
+
+    auto population = nw->population + ne->population + sw->population + se->population;
+    m_nodes.push_back(Node{ nw, ne, sw, se, nw->level + 1, population, nullptr, -1 });
+    auto* node = &m_nodes.back();
+    m_table.emplace(key, node);
+    return node;
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::EmptyNode(int level)
+{
+    if (m_emptyNodes.empty())
+        m_emptyNodes.push_back(&m_deadLeaf);
+
+    while (static_cast<int>(m_emptyNodes.size()) <= level)
+    {
+        auto* child = m_emptyNodes.back();
+        m_emptyNodes.push_back(Join(child, child, child, child));
+    }
+    return m_emptyNodes[level];
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::Centre(const Node* node)
+{
+    return Join(node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::Expand(const Node* node)
+{
+    auto* empty = EmptyNode(node->level - 1);
+    return Join(
+        Join(empty, empty, empty, node->nw),
+        Join(empty, empty, node->ne, empty),
+        Join(empty, node->sw, empty, empty),
+        Join(node->se, empty, empty, empty));
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::BaseSuccessor(const Node* node)
+{
+    // 4x4 block, bit (r * 4 + c)
+    auto cells = 0u;
+    auto put = [&cells](const Node* quadrant, int r, int c)
+    {
+        cells |= static_cast<unsigned>(quadrant->nw->population) << (r * 4 + c);
+        cells |= static_cast<unsigned>(quadrant->ne->population) << (r * 4 + c + 1);
+        cells |= static_cast<unsigned>(quadrant->sw->population) << ((r + 1) * 4 + c);
+        cells |= static_cast<unsigned>(quadrant->se->population) << ((r + 1) * 4 + c + 1);
+    };
+    put(node->nw, 0, 0);
+    put(node->ne, 0, 2);
+    put(node->sw, 2, 0);
+    put(node->se, 2, 2);
+
+    auto centre = m_lookupTable[cells];
+    auto leaf = [centre, this](int bit) { return (centre >> bit) & 1 ? &m_aliveLeaf : &m_deadLeaf; };
+    return Join(leaf(0), leaf(1), leaf(2), leaf(3));
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::Successor(const Node* node, int step)
+{
+    if (node->population == 0)
+        return EmptyNode(node->level - 1);
+    if (node->result && node->resultStep == step)
+        return node->result;
+
+    const Node* result;
+    if (node->level == 2)
+    {
+        result = BaseSuccessor(node);
+    }
+    else
+    {
+        auto* nw = node->nw;
+        auto* ne = node->ne;
+        auto* sw = node->sw;
+        auto* se = node->se;
+
+        // the 9 overlapping sub-squares of half the size
+        const Node* sub[3][3] = {
+            { nw, Join(nw->ne, ne->nw, nw->se, ne->sw), ne },
+            { Join(nw->sw, nw->se, sw->nw, sw->ne), Centre(node), Join(ne->sw, ne->se, se->nw, se->ne) },
+            { sw, Join(sw->ne, se->nw, sw->se, se->sw), se },
+        };
+
+        // At full speed both halves of the jump go through Successor; for smaller
+        // steps the first half only takes the centres, without advancing time.
+        auto fullSpeed = step == node->level - 2;
+        auto nextStep = fullSpeed ? step - 1 : step;
+        for (auto& row : sub)
+        {
+            for (auto& square : row)
+                square = fullSpeed ? Successor(square, nextStep) : Centre(square);
+        }
+
+        result = Join(
+            Successor(Join(sub[0][0], sub[0][1], sub[1][0], sub[1][1]), nextStep),
+            Successor(Join(sub[0][1], sub[0][2], sub[1][1], sub[1][2]), nextStep),
+            Successor(Join(sub[1][0], sub[1][1], sub[2][0], sub[2][1]), nextStep),
+            Successor(Join(sub[1][1], sub[1][2], sub[2][1], sub[2][2]), nextStep));
+    }
+
+    node->result = result;
+    node->resultStep = step;
+    return result;
+}
+
+bool GameOfLife_HashLife::Advance(std::uint64_t generations)
+{
+    // a jump of 2^step needs a root of level step + 3
+    if (generations >> (MaxLevel - 2))
+        return false;
+
+    for (int step = 0; generations; step++, generations >>= 1)
+    {
+        if (!(generations & 1))
+            continue;
+
+        // Cells move at most one cell per generation, so the pattern has to sit in the
+        // centre quarter of a root at least 2^(step + 3) wide to stay inside the result.
+        while (m_root->level < step + 3 || Centre(Centre(m_root))->population != m_root->population)
+        {
+            if (m_root->level == MaxLevel)
+                return false;
+            m_root = Expand(m_root);
+        }
+
+        if (m_nodes.size() > m_maxNodes)
+            CollectGarbage();
+
+        m_root = Successor(m_root, step);
+        m_generation += std::uint64_t(1) << step;
+    }
+    return true;
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::Copy(const Node* node, std::unordered_map<const Node*, const Node*>& copies)
+{
+    if (node->level == 0)
+        return node;
+
+    auto found = copies.find(node);
+    if (found != copies.end())
+        return found->second;
+
+    auto* copy = Join(Copy(node->nw, copies), Copy(node->ne, copies), Copy(node->sw, copies), Copy(node->se, copies));
+    copies.emplace(node, copy);
+    return copy;
+}
+
+void GameOfLife_HashLife::CollectGarbage()
+{
+    auto oldNodes = std::deque<Node>();
+    auto oldTable = std::unordered_map<NodeKey, const Node*, NodeKeyHash>();
+    oldNodes.swap(m_nodes);
+    oldTable.swap(m_table);
+    m_emptyNodes.clear();
+
+    auto copies = std::unordered_map<const Node*, const Node*>();
+    m_root = Copy(m_root, copies);
+}
+
+std::int64_t GameOfLife_HashLife::RootHalfSize() const
+{
+    return std::int64_t(1) << (m_root->level - 1);
+}
+
+bool GameOfLife_HashLife::GetCell(std::int64_t x, std::int64_t y) const
+{
+    auto half = RootHalfSize();
+    if (x < -half || y < -half || x >= half || y >= half)
+        return false;
+
+    // walk down with coordinates relative to the current node's centre
+    const auto* node = m_root;
+    while (node->level > 0 && node->population)
+    {
+        auto quarter = node->level == 1 ? 0 : std::int64_t(1) << (node->level - 2);
+        auto north = x < 0;
+        auto west = y < 0;
+        node = north ? (west ? node->nw : node->ne) : (west ? node->sw : node->se);
+        if (node->level > 0)
+        {
+            x += north ? quarter : -quarter;
+            y += west ? quarter : -quarter;
+        }
+    }
+    return node->population != 0;
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::SetCell(const Node* node, std::int64_t x, std::int64_t y, bool alive)
+{
+    if (node->level == 0)
+        return alive ? &m_aliveLeaf : &m_deadLeaf;
+
+    auto half = std::int64_t(1) << (node->level - 1);
+    auto north = x < half;
+    auto west = y < half;
+    auto childX = north ? x : x - half;
+    auto childY = west ? y : y - half;
+    if (north && west)
+        return Join(SetCell(node->nw, childX, childY, alive), node->ne, node->sw, node->se);
+    if (north)
+        return Join(node->nw, SetCell(node->ne, childX, childY, alive), node->sw, node->se);
+    if (west)
+        return Join(node->nw, node->ne, SetCell(node->sw, childX, childY, alive), node->se);
+    return Join(node->nw, node->ne, node->sw, SetCell(node->se, childX, childY, alive));
+}
+
+bool GameOfLife_HashLife::SetCell(std::int64_t x, std::int64_t y, bool alive)
+{
+    constexpr auto MaxHalf = std::int64_t(1) << (MaxLevel - 1);
+    if (x < -MaxHalf || y < -MaxHalf || x >= MaxHalf || y >= MaxHalf)
+        return false;
+
+    while (x < -RootHalfSize() || y < -RootHalfSize() || x >= RootHalfSize() || y >= RootHalfSize())
+        m_root = Expand(m_root);
+
+    auto half = RootHalfSize();
+    m_root = SetCell(m_root, x + half, y + half, alive);
+    return true;
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::Build(const std::vector<std::vector<bool>>& cells, int level, std::int64_t x, std::int64_t y)
+{
+    auto size = std::int64_t(1) << level;
+    auto nrRows = static_cast<std::int64_t>(cells.size());
+    auto nrCols = nrRows ? static_cast<std::int64_t>(cells.front().size()) : 0;
+    if (x + size <= 0 || y + size <= 0 || x >= nrRows || y >= nrCols)
+        return EmptyNode(level);
+
+    if (level == 0)
+        return cells[x][y] ? &m_aliveLeaf : &m_deadLeaf;
+
+    auto half = size / 2;
+    return Join(
+        Build(cells, level - 1, x, y),
+        Build(cells, level - 1, x, y + half),
+        Build(cells, level - 1, x + half, y),
+        Build(cells, level - 1, x + half, y + half));
+}
+
+void GameOfLife_HashLife::SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart)
+{
+    for (const auto& [x, y] : aliveCellsAtStart)
+    {
+        SetCell(x, y, true);
+    }
+}
+
+void GameOfLife_HashLife::SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart)
+{
+    auto size = std::max<std::size_t>(aliveCellsAtStart.size(), aliveCellsAtStart.empty() ? 0 : aliveCellsAtStart.front().size());
+    auto level = 3;
+    while ((std::size_t(1) << (level - 1)) < size)
+        level++;
+
+    auto half = std::int64_t(1) << (level - 1);
+    m_root = Build(aliveCellsAtStart, level, -half, -half);
+}
+
+State GameOfLife_HashLife::GetState(std::int64_t x, std::int64_t y, int nrRows, int nrCols) const
+{
+    auto state = State(nrRows, std::vector<bool>(nrCols));
+    auto half = RootHalfSize();
+    Rasterize(m_root, -half, -half, state, x, y);
+    return state;
+}
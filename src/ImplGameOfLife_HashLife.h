@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+#include <ImplGameOfLife.h>
+#include <Rule.h>
+
+class GameOfLife_BitPacked;
+
+// Unbounded universe stored as a hash-consed quadtree. A node of level k covers
+// 2^k x 2^k cells; equal subtrees are shared, and the RESULT of every node (its
+// centre advanced by 2^step generations) is memoized on the node itself.
+// Coordinates are (row, col) like the other engines, and may be negative.
+class GameOfLife_HashLife
+{
+public:
+    struct Node
+    {
+        const Node* nw;
+        const Node* ne;
+        const Node* sw;
+        const Node* se;
+        int level;
+        std::uint64_t population;
+        mutable const Node* result;
+        mutable int resultStep;
+    };
+
+    // Deepest root; its cells span [-2^61, 2^61) on both axes, so coordinates and sizes stay
+    // within 64 bits.
+    static constexpr int MaxLevel = 62;
+
+    GameOfLife_HashLife();
+    GameOfLife_HashLife(const GameOfLife_HashLife&) = delete;
+    GameOfLife_HashLife& operator=(const GameOfLife_HashLife&) = delete;
+    GameOfLife_HashLife(GameOfLife_HashLife&&) = delete;
+    GameOfLife_HashLife& operator=(GameOfLife_HashLife&&) = delete;
+
+    void SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart);
+    void SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart);
+
+    // Cells of the rectangle starting at (x, y), in the layout of the other engines' State.
+    State GetState(std::int64_t x, std::int64_t y, int nrRows, int nrCols) const;
+
+    bool GetCell(std::int64_t x, std::int64_t y) const;
+    // False, leaving the universe as it was, for a cell beyond the reach of a MaxLevel root.
+    bool SetCell(std::int64_t x, std::int64_t y, bool alive);
+
+    // Drops all memoized results, they were computed under the previous rule.
+    void SetRule(const Rule& rule);
+    const Rule& GetRule() const
+    {
+        return m_rule;
+    }
+
+    // False when the jump would need a root deeper than MaxLevel: right away for 2^60 or more
+    // generations, otherwise once the pattern has spread too far, in which case Generation()
+    // tells how far it got.
+    bool Advance(std::uint64_t generations);
+
+    std::uint64_t Generation() const
+    {
+        return m_generation;
+    }
+    std::uint64_t Population() const
+    {
+        return m_root->population;
+    }
+    std::size_t NrNodes() const
+    {
+        return m_nodes.size();
+    }
+
+    // Golly's macrocell format: one line per distinct node, children referring to earlier lines,
+    // so shared subtrees are stored once and the file is as compact as the tree. Level 3 nodes
+    // are written as 8 x 8 bitmaps. The root is centred on the origin, the rule and generation
+    // travel in #R and #G lines. Reading replaces the universe; false when the file is malformed.
+    // Both refuse roots deeper than MaxLevel.
+    bool ReadMacrocell(std::istream& in);
+    bool WriteMacrocell(std::ostream& out) const;
+
+    // Hands a region over to a dense engine: gol becomes the Height() x Width() rectangle starting
+    // at (x, y). Only the nodes overlapping the rectangle are visited. False for a root deeper
+    // than MaxLevel, whose coordinates do not fit in 64 bits.
+    bool RasterizeRegion(GameOfLife_BitPacked& gol, std::int64_t x, std::int64_t y) const;
+
+    // The node table is rebuilt from the live tree whenever it grows past this many nodes.
+    void SetMaxNodes(std::size_t maxNodes)
+    {
+        m_maxNodes = maxNodes;
+    }
+    void CollectGarbage();
+
+private:
+    struct NodeKey
+    {
+        const Node* nw;
+        const Node* ne;
+        const Node* sw;
+        const Node* se;
+
+        bool operator==(const NodeKey& other) const
+        {
+            return nw == other.nw && ne == other.ne && sw == other.sw && se == other.se;
+        }
+    };
+
+    struct NodeKeyHash
+    {
+        std::size_t operator()(const NodeKey& key) const;
+    };
+
+    const Node* Join(const Node* nw, const Node* ne, const Node* sw, const Node* se);
+    const Node* EmptyNode(int level);
+    const Node* Centre(const Node* node);
+    const Node* Expand(const Node* node);
+    const Node* Successor(const Node* node, int step);
+    const Node* BaseSuccessor(const Node* node);
+    const Node* Build(const std::vector<std::vector<bool>>& cells, int level, std::int64_t x, std::int64_t y);
+    const Node* SetCell(const Node* node, std::int64_t x, std::int64_t y, bool alive);
+    // Level 3 node from an 8 x 8 bitmap, bit 8 * row + col.
+    const Node* LeafSquare(std::uint64_t bits, int level, int x, int y);
+    const Node* Copy(const Node* node, std::unordered_map<const Node*, const Node*>& copies);
+
+    // Half the side of the root; the root covers [-half, half) on both axes.
+    std::int64_t RootHalfSize() const;
+
+    Rule m_rule = ConwayLife;
+    const std::uint8_t* m_lookupTable = nullptr;
+    Node m_deadLeaf;
+    Node m_aliveLeaf;
+    std::deque<Node> m_nodes;
+    std::unordered_map<NodeKey, const Node*, NodeKeyHash> m_table;
+    std::vector<const Node*> m_emptyNodes;
+    const Node* m_root = nullptr;
+    std::uint64_t m_generation = 0;
+    std::size_t m_maxNodes = std::size_t(1) << 24;
+};
@@ -0,0 +1,269 @@
+#include <ImplGameOfLife_HashLife.h>
+
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <ImplGameOfLife_BitPacked.h>
+
+namespace
+{
+    using Node = GameOfLife_HashLife::Node;
+
+    constexpr int LeafLevel = 3;
+    constexpr std::size_t ChunkBytes = std::size_t(1) << 16;
+
+    // bit 8 * row + col of an 8 x 8 node
+    void CollectLeafBits(const Node* node, int x, int y, std::uint64_t& bits)
+    {
+        if (node->population == 0)
+            return;
+        if (node->level == 0)
+        {
+            bits |= std::uint64_t(1) << (x * 8 + y);
+            return;
+        }
+
+        auto half = 1 << (node->level - 1);
+        CollectLeafBits(node->nw, x, y, bits);
+        CollectLeafBits(node->ne, x, y + half, bits);
+        CollectLeafBits(node->sw, x + half, y, bits);
+        CollectLeafBits(node->se, x + half, y + half, bits);
+    }
+
+    bool ParseLeafLine(const std::string& line, std::uint64_t& bits)
+    {
+        bits = 0;
+        auto row = 0;
+        auto col = 0;
+        for (auto c : line)
+        {
+            if (c == '$')
+            {
+                row++;
+                col = 0;
+                continue;
+            }
+            if ((c != '.' && c != '*') || row >= 8 || col >= 8)
+                return false;
+            if (c == '*')
+                bits |= std::uint64_t(1) << (row * 8 + col);
+            col++;
+        }
+        return true;
+    }
+
+    void AppendLeafLine(std::string& text, std::uint64_t bits)
+    {
+        for (int row = 0; row < 8 && (bits >> (row * 8)); row++)
+        {
+            auto rowBits = (bits >> (row * 8)) & 0xFF;
+            for (int col = 0; rowBits >> col; col++)
+                text += (rowBits >> col) & 1 ? '*' : '.';
+            text += '$';
+        }
+        text += '\n';
+    }
+
+    // Row band of a dense board that region cells are rasterized into.
+    struct Band
+    {
+        std::int64_t startRow;  // in universe coordinates
+        std::int64_t startCol;
+        int nrRows;
+        int nrCols;
+        int wordsPerRow;
+        std::vector<Word> words;
+    };
+
+    void RasterizeNode(const Node* node, std::int64_t nodeX, std::int64_t nodeY, Band& band)
+    {
+        if (node->population == 0)
+            return;
+
+        auto size = std::int64_t(1) << node->level;
+        if (nodeX + size <= band.startRow || nodeY + size <= band.startCol || nodeX >= band.startRow + band.nrRows || nodeY >= band.startCol + band.nrCols)
+            return;
+
+        if (node->level == LeafLevel)
+        {
+            auto bits = std::uint64_t(0);
+            CollectLeafBits(node, 0, 0, bits);
+            while (bits)
+            {
+                auto bit = BitKernels::LowestBitIndex(bits);
+                bits &= bits - 1;
+                auto row = nodeX + bit / 8 - band.startRow;
+                auto col = nodeY + bit % 8 - band.startCol;
+                if (row >= 0 && col >= 0 && row < band.nrRows && col < band.nrCols)
+                    band.words[row * band.wordsPerRow + col / GameOfLife_BitPacked::BitsPerWord] |= Word(1) << (col % GameOfLife_BitPacked::BitsPerWord);
+            }
+            return;
+        }
+
+        auto half = size / 2;
+        RasterizeNode(node->nw, nodeX, nodeY, band);
+        RasterizeNode(node->ne, nodeX, nodeY + half, band);
+        RasterizeNode(node->sw, nodeX + half, nodeY, band);
+        RasterizeNode(node->se, nodeX + half, nodeY + half, band);
+    }
+}
+
+const GameOfLife_HashLife::Node* GameOfLife_HashLife::LeafSquare(std::uint64_t bits, int level, int x, int y)
+{
+    if (level == 0)
+        return (bits >> (x * 8 + y)) & 1 ? &m_aliveLeaf : &m_deadLeaf;
+
+    auto half = 1 << (level - 1);
+    return Join(
+        LeafSquare(bits, level - 1, x, y),
+        LeafSquare(bits, level - 1, x, y + half),
+        LeafSquare(bits, level - 1, x + half, y),
+        LeafSquare(bits, level - 1, x + half, y + half));
+}
+
+bool GameOfLife_HashLife::ReadMacrocell(std::istream& in)
+{
+    auto line = std::string();
+    if (!std::getline(in, line) || line.compare(0, 4, "[M2]") != 0)
+        return false;
+
+    auto rule = m_rule;
+    auto generation = std::uint64_t(0);
+    // nodes[i] is the node on data line i; 0 stands for the empty node of the level needed
+    auto nodes = std::vector<const Node*>{ nullptr };
+    while (std::getline(in, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+
+        if (line.front() == '#')
+        {
+            if (line.compare(0, 2, "#R") == 0)
+            {
+                auto text = line.substr(2);
+                text.erase(0, text.find_first_not_of(' '));
+                if (!ParseRule(text.substr(0, text.find(':')), rule))
+                    return false;
+            }
+            else if (line.compare(0, 2, "#G") == 0)
+            {
+                std::istringstream(line.substr(2)) >> generation;
+            }
+            continue;
+        }
+
+        if (line.front() == '.' || line.front() == '*' || line.front() == '$')
+        {
+            auto bits = std::uint64_t(0);
+            if (!ParseLeafLine(line, bits))
+                return false;
+            nodes.push_back(LeafSquare(bits, LeafLevel, 0, 0));
+            continue;
+        }
+
+        auto fields = std::istringstream(line);
+        int level;
+        std::size_t children[4];
+        if (!(fields >> level >> children[0] >> children[1] >> children[2] >> children[3]) || level <= LeafLevel || level > MaxLevel)
+            return false;
+
+        const Node* quadrants[4];
+        for (int i = 0; i < 4; i++)
+        {
+            if (children[i] >= nodes.size())
+                return false;
+            quadrants[i] = children[i] == 0 ? EmptyNode(level - 1) : nodes[children[i]];
+            if (quadrants[i]->level != level - 1)
+                return false;
+        }
+        nodes.push_back(Join(quadrants[0], quadrants[1], quadrants[2], quadrants[3]));
+    }
+
+    m_root = nodes.size() > 1 ? nodes.back() : EmptyNode(LeafLevel);
+    m_generation = generation;
+    // also drops whatever the previous universe left in the node table
+    SetRule(rule);
+    return true;
+}
+
+bool GameOfLife_HashLife::WriteMacrocell(std::ostream& out) const
+{
+    // the reader would refuse it
+    if (m_root->level > MaxLevel)
+        return false;
+
+    auto text = "[M2] (gameoflife)\n#R " + RuleToString(m_rule) + "\n#G " + std::to_string(m_generation) + "\n";
+    auto indices = std::unordered_map<const Node*, std::uint64_t>();
+    auto nextIndex = std::uint64_t(1);
+
+    // children are numbered, and their lines written, before their parents
+    std::function<std::uint64_t(const Node*)> number = [&](const Node* node)
+    {
+        if (node->population == 0)
+            return std::uint64_t(0);
+        auto found = indices.find(node);
+        if (found != indices.end())
+            return found->second;
+
+        if (node->level == LeafLevel)
+        {
+            auto bits = std::uint64_t(0);
+            CollectLeafBits(node, 0, 0, bits);
+            AppendLeafLine(text, bits);
+        }
+        else
+        {
+            auto nw = number(node->nw);
+            auto ne = number(node->ne);
+            auto sw = number(node->sw);
+            auto se = number(node->se);
+            text += std::to_string(node->level) + ' ' + std::to_string(nw) + ' ' + std::to_string(ne) + ' ' + std::to_string(sw) + ' ' + std::to_string(se) + '\n';
+        }
+
+        if (text.size() >= ChunkBytes)
+        {
+            out.write(text.data(), static_cast<std::streamsize>(text.size()));
+            text.clear();
+        }
+        indices.emplace(node, nextIndex);
+        return nextIndex++;
+    };
+    number(m_root);
+
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return static_cast<bool>(out);
+}
+
+bool GameOfLife_HashLife::RasterizeRegion(GameOfLife_BitPacked& gol, std::int64_t x, std::int64_t y) const
+{
+    // the node coordinates below would not fit in 64 bits
+    if (m_root->level > MaxLevel)
+        return false;
+
+    // one band of rows at a time, so there is never more than a band besides the board
+    constexpr int BandRows = 64;
+    auto half = RootHalfSize();
+    // a region beyond the root is empty, and leaving it out keeps the band coordinates in range
+    auto overlaps = x < half && y < half && x >= -half - gol.Height() && y >= -half - gol.Width();
+    auto band = Band{ 0, y, 0, gol.Width(), gol.WordsPerRow(), {} };
+    for (int startRow = 0; startRow < gol.Height(); startRow += BandRows)
+    {
+        band.nrRows = std::min(BandRows, gol.Height() - startRow);
+        band.words.assign(static_cast<std::size_t>(band.nrRows) * band.wordsPerRow, 0);
+        if (overlaps)
+        {
+            band.startRow = x + startRow;
+            RasterizeNode(m_root, -half, -half, band);
+        }
+
+        for (int i = 0; i < band.nrRows; i++)
+            gol.SetRow(startRow + i, band.words.data() + static_cast<std::size_t>(i) * band.wordsPerRow);
+    }
+    return true;
+}
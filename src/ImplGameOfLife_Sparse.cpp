@@ -0,0 +1,256 @@
+#include <ImplGameOfLife_Sparse.h>
+
+#include <algorithm>
+#include <Partitioning.h>
+
+namespace
+{
+    // A chunk next to an oscillating edge would otherwise be freed and allocated again every other generation.
+    constexpr int EmptyGenerationsBeforeFree = 4;
+
+    std::int64_t ChunkIndex(std::int64_t coord)
+    {
+        return coord >= 0 ? coord / GameOfLife_Sparse::ChunkSize : -((-coord + GameOfLife_Sparse::ChunkSize - 1) / GameOfLife_Sparse::ChunkSize);
+    }
+
+    int ChunkOffset(std::int64_t coord)
+    {
+        return static_cast<int>(coord - ChunkIndex(coord) * GameOfLife_Sparse::ChunkSize);
+    }
+}
+
+std::size_t GameOfLife_Sparse::ChunkKeyHash::operator()(const ChunkKey& key) const
+{
+    auto hash = static_cast<std::uint64_t>(key.row) * 0x9E3779B97F4A7C15ull;
+    hash = (hash ^ (hash >> 32)) + static_cast<std::uint64_t>(key.col);
+    hash *= 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(hash ^ (hash >> 29));
+}
+
+GameOfLife_Sparse::GameOfLife_Sparse()
+{
+    SetRule(m_rule);
+}
+
+void GameOfLife_Sparse::SetRule(const Rule& rule)
+{
+    // chunks are a single word wide, which the vector kernels would hand to the scalar tail anyway
+    m_rule = rule;
+    m_rowKernel = BitKernels::SelectRowKernel(BitKernels::Isa::Scalar, m_rule);
+}
+
+GameOfLife_Sparse::ChunkKey GameOfLife_Sparse::KeyOf(std::int64_t x, std::int64_t y)
+{
+    return ChunkKey{ ChunkIndex(x), ChunkIndex(y) };
+}
+
+const GameOfLife_Sparse::Chunk* GameOfLife_Sparse::FindChunk(const ChunkKey& key) const
+{
+    auto found = m_chunks.find(key);
+    return found == m_chunks.end() ? nullptr : &found->second;
+}
+
+bool GameOfLife_Sparse::GetCell(std::int64_t x, std::int64_t y) const
+{
+    const auto* chunk = FindChunk(KeyOf(x, y));
+    return chunk && ((chunk->cells[ChunkOffset(x)] >> ChunkOffset(y)) & 1);
+}
+
+void GameOfLife_Sparse::SetCell(std::int64_t x, std::int64_t y, bool alive)
+{
+    auto bit = Word(1) << ChunkOffset(y);
+    if (alive)
+    {
+        m_chunks[KeyOf(x, y)].cells[ChunkOffset(x)] |= bit;
+        return;
+    }
+
+    auto found = m_chunks.find(KeyOf(x, y));
+    if (found != m_chunks.end())
+        found->second.cells[ChunkOffset(x)] &= ~bit;
+}
+
+void GameOfLife_Sparse::SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart)
+{
+    for (const auto& [x, y] : aliveCellsAtStart)
+    {
+        SetCell(x, y, true);
+    }
+}
+
+void GameOfLife_Sparse::SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart)
+{
+    for (std::size_t i = 0; i < aliveCellsAtStart.size(); i++)
+    {
+        for (std::size_t j = 0; j < aliveCellsAtStart[i].size(); j++)
+        {
+            if (aliveCellsAtStart[i][j])
+                SetCell(static_cast<std::int64_t>(i), static_cast<std::int64_t>(j), true);
+        }
+    }
+}
+
+State GameOfLife_Sparse::GetState(std::int64_t x, std::int64_t y, int nrRows, int nrCols) const
+{
+    auto state = State(nrRows, std::vector<bool>(nrCols));
+    for (const auto& [key, chunk] : m_chunks)
+    {
+        auto chunkX = key.row * ChunkSize;
+        auto chunkY = key.col * ChunkSize;
+        if (chunkX + ChunkSize <= x || chunkY + ChunkSize <= y || chunkX >= x + nrRows || chunkY >= y + nrCols)
+            continue;
+
+        for (int i = 0; i < ChunkSize; i++)
+        {
+            auto row = chunk.cells[i];
+            while (row)
+            {
+                auto j = BitKernels::LowestBitIndex(row);
+                row &= row - 1;
+                auto cellX = chunkX + i - x;
+                auto cellY = chunkY + j - y;
+                if (cellX >= 0 && cellY >= 0 && cellX < nrRows && cellY < nrCols)
+                    state[cellX][cellY] = true;
+            }
+        }
+    }
+    return state;
+}
+
+std::uint64_t GameOfLife_Sparse::Population() const
+{
+    auto population = std::uint64_t(0);
+    for (const auto& [key, chunk] : m_chunks)
+    {
+        for (auto row : chunk.cells)
+            population += BitKernels::PopCount(row);
+    }
+    return population;
+}
+
+void GameOfLife_Sparse::AddChunksAtActiveEdges()
+{
+    auto newKeys = std::vector<ChunkKey>();
+    auto addIfMissing = [&](const ChunkKey& key, std::int64_t rowOffset, std::int64_t colOffset)
+    {
+        auto neighborKey = ChunkKey{ key.row + rowOffset, key.col + colOffset };
+        if (m_chunks.find(neighborKey) == m_chunks.end())
+            newKeys.push_back(neighborKey);
+    };
+
+    for (const auto& [key, chunk] : m_chunks)
+    {
+        auto west = Word(0);
+        auto east = Word(0);
+        for (auto row : chunk.cells)
+        {
+            west |= row & 1;
+            east |= row >> (ChunkSize - 1);
+        }
+        auto top = chunk.cells.front();
+        auto bottom = chunk.cells.back();
+
+        if (top)
+            addIfMissing(key, -1, 0);
+        if (bottom)
+            addIfMissing(key, 1, 0);
+        if (west)
+            addIfMissing(key, 0, -1);
+        if (east)
+            addIfMissing(key, 0, 1);
+        if (top & 1)
+            addIfMissing(key, -1, -1);
+        if (top >> (ChunkSize - 1))
+            addIfMissing(key, -1, 1);
+        if (bottom & 1)
+            addIfMissing(key, 1, -1);
+        if (bottom >> (ChunkSize - 1))
+            addIfMissing(key, 1, 1);
+    }
+
+    for (const auto& key : newKeys)
+        m_chunks.try_emplace(key);
+}
+
+void GameOfLife_Sparse::GenNextChunk(const ChunkKey& key, Chunk& chunk) const
+{
+    const Chunk* neighbors[3][3];
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+            neighbors[i][j] = FindChunk(ChunkKey{ key.row + i - 1, key.col + j - 1 });
+    }
+
+    // rows of three words (west, own, east), with the last row of the chunks above first and
+    // the first row of the chunks below last, so the row kernel sees a bordered 1-word board
+    constexpr auto stride = 3;
+    Word rows[(ChunkSize + 2) * stride];
+    auto fillRow = [&](int bufferRow, int neighborRow, int chunkRow)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            const auto* neighbor = neighbors[neighborRow][j];
+            rows[bufferRow * stride + j] = neighbor ? neighbor->cells[chunkRow] : 0;
+        }
+    };
+    fillRow(0, 0, ChunkSize - 1);
+    for (int i = 0; i < ChunkSize; i++)
+        fillRow(i + 1, 1, i);
+    fillRow(ChunkSize + 1, 2, 0);
+
+    for (int i = 0; i < ChunkSize; i++)
+    {
+        const auto* row = rows + (i + 1) * stride + 1;
+        m_rowKernel(row - stride, row, row + stride, &chunk.next[i], 0, 1, m_rule);
+    }
+}
+
+void GameOfLife_Sparse::CommitNextChunks()
+{
+    for (auto it = m_chunks.begin(); it != m_chunks.end();)
+    {
+        auto& chunk = it->second;
+        chunk.cells = chunk.next;
+        auto empty = std::all_of(chunk.cells.begin(), chunk.cells.end(), [](Word row) { return row == 0; });
+        chunk.nrEmptyGenerations = empty ? chunk.nrEmptyGenerations + 1 : 0;
+        if (chunk.nrEmptyGenerations >= EmptyGenerationsBeforeFree)
+            it = m_chunks.erase(it);
+        else
+            ++it;
+    }
+}
+
+void GameOfLife_Sparse::Step()
+{
+    AddChunksAtActiveEdges();
+    for (auto& [key, chunk] : m_chunks)
+        GenNextChunk(key, chunk);
+    CommitNextChunks();
+    m_generation++;
+}
+
+void GameOfLife_Sparse::Step(ThreadPool& pool)
+{
+    AddChunksAtActiveEdges();
+    auto chunks = std::vector<std::pair<const ChunkKey*, Chunk*>>();
+    chunks.reserve(m_chunks.size());
+    for (auto& [key, chunk] : m_chunks)
+        chunks.emplace_back(&key, &chunk);
+
+    // a chunk is too little work for a task of its own
+    auto nrTasks = std::max(std::min(static_cast<int>(chunks.size()), pool.NrThreads() * 8), 1);
+    auto boundaries = SplitRange(static_cast<int>(chunks.size()), nrTasks);
+    pool.ParallelFor(nrTasks, [&](int task)
+    {
+        for (int i = boundaries[task]; i < boundaries[task + 1]; i++)
+            GenNextChunk(*chunks[i].first, *chunks[i].second);
+    });
+    CommitNextChunks();
+    m_generation++;
+}
+
+void GameOfLife_Sparse::Advance(std::uint64_t generations)
+{
+    for (std::uint64_t generation = 0; generation < generations; generation++)
+        Step();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <BitKernels.h>
+#include <ImplGameOfLife.h>
+#include <Rule.h>
+#include <ThreadPool.h>
+
+// Unbounded universe stored as a hash map of 64 x 64 bit-packed chunks keyed by chunk
+// coordinates. A chunk is allocated when live cells reach the edge facing it and freed once
+// it has stayed empty for a few generations, so memory follows the live area rather than
+// the bounding box. Coordinates are (row, col) like the other engines, and may be negative.
+class GameOfLife_Sparse
+{
+public:
+    static constexpr int ChunkSize = 64;
+
+    GameOfLife_Sparse();
+    GameOfLife_Sparse(const GameOfLife_Sparse&) = delete;
+    GameOfLife_Sparse& operator=(const GameOfLife_Sparse&) = delete;
+    GameOfLife_Sparse(GameOfLife_Sparse&&) = delete;
+    GameOfLife_Sparse& operator=(GameOfLife_Sparse&&) = delete;
+
+    void SetInitialState(const std::vector<std::pair<int, int>>& aliveCellsAtStart);
+    // Cell (i, j) of the state goes to (i, j).
+    void SetInitialState(const std::vector<std::vector<bool>>& aliveCellsAtStart);
+
+    // Cells of the rectangle starting at (x, y), in the layout of the other engines' State.
+    State GetState(std::int64_t x, std::int64_t y, int nrRows, int nrCols) const;
+
+    bool GetCell(std::int64_t x, std::int64_t y) const;
+    void SetCell(std::int64_t x, std::int64_t y, bool alive);
+
+    void SetRule(const Rule& rule);
+    const Rule& GetRule() const
+    {
+        return m_rule;
+    }
+
+    void Step();
+    // Same as Step, with the chunks computed on the pool's workers.
+    void Step(ThreadPool& pool);
+    void Advance(std::uint64_t generations);
+
+    std::uint64_t Generation() const
+    {
+        return m_generation;
+    }
+    std::uint64_t Population() const;
+    std::size_t NrChunks() const
+    {
+        return m_chunks.size();
+    }
+
+private:
+    struct ChunkKey
+    {
+        std::int64_t row;
+        std::int64_t col;
+
+        bool operator==(const ChunkKey& other) const
+        {
+            return row == other.row && col == other.col;
+        }
+    };
+
+    struct ChunkKeyHash
+    {
+        std::size_t operator()(const ChunkKey& key) const;
+    };
+
+    // One word per row, bit j is column j of the chunk.
+    struct Chunk
+    {
+        std::array<Word, ChunkSize> cells{};
+        std::array<Word, ChunkSize> next{};
+        int nrEmptyGenerations = 0;
+    };
+
+    static ChunkKey KeyOf(std::int64_t x, std::int64_t y);
+    const Chunk* FindChunk(const ChunkKey& key) const;
+    // Allocates the chunks next to an edge or corner of a chunk that has live cells on it.
+    void AddChunksAtActiveEdges();
+    void GenNextChunk(const ChunkKey& key, Chunk& chunk) const;
+    void CommitNextChunks();
+
+    Rule m_rule = ConwayLife;
+    BitKernels::RowKernel m_rowKernel = nullptr;
+    std::unordered_map<ChunkKey, Chunk, ChunkKeyHash> m_chunks;
+    std::uint64_t m_generation = 0;
+};
@@ -0,0 +1,193 @@
+#include <ImplGameOfLife_Streaming.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <FileWriter.h>
+#include <ImplGameOfLife_BitPacked.h>
+#include <ThreadUtils.h>
+
+namespace
+{
+    // One row with a zero ghost word on each side, so the row kernel can read past both ends.
+    using RowBuffer = std::vector<Word>;
+
+    constexpr std::size_t FileBufferBytes = std::size_t(1) << 20;
+
+    // Also through links and other spellings of the same path; a path that does not exist yet
+    // is a different file.
+    bool IsSameFile(const std::string& first, const std::string& second)
+    {
+        auto error = std::error_code();
+        return first == second || std::filesystem::equivalent(first, second, error);
+    }
+
+    struct BufferedFile
+    {
+        std::unique_ptr<char[]> buffer = std::make_unique<char[]>(FileBufferBytes);
+    };
+}
+
+GameOfLife_Streaming::GameOfLife_Streaming(int width, int height, int queueRows) :
+    m_width(width),
+    m_height(height),
+    m_wordsPerRow((width + GameOfLife_BitPacked::BitsPerWord - 1) / GameOfLife_BitPacked::BitsPerWord),
+    m_lastWordMask(width % GameOfLife_BitPacked::BitsPerWord == 0 ? ~Word(0) : (Word(1) << (width % GameOfLife_BitPacked::BitsPerWord)) - 1),
+    m_queueRows(std::max(queueRows, 1))
+{
+    SetIsa(BitKernels::DetectIsa());
+}
+
+void GameOfLife_Streaming::SetIsa(BitKernels::Isa isa)
+{
+    m_isa = std::min(isa, BitKernels::DetectIsa());
+    m_rowKernel = BitKernels::SelectRowKernel(m_isa, m_rule);
+}
+
+void GameOfLife_Streaming::SetRule(const Rule& rule)
+{
+    m_rule = rule;
+    m_rowKernel = BitKernels::SelectRowKernel(m_isa, m_rule);
+}
+
+bool GameOfLife_Streaming::Step(std::istream& input, std::ostream& output)
+{
+    auto rowBytes = static_cast<std::streamsize>(m_wordsPerRow * sizeof(Word));
+    auto queueRows = static_cast<std::size_t>(m_queueRows);
+
+    // filled rows travel forward through inputRows and outputRows, drained ones come back
+    // through the free queues, so no row is allocated after the start
+    BoundedQueue<RowBuffer> freeInputRows(queueRows + 3);
+    BoundedQueue<RowBuffer> inputRows(queueRows);
+    BoundedQueue<RowBuffer> freeOutputRows(queueRows + 1);
+    BoundedQueue<RowBuffer> outputRows(queueRows);
+    for (std::size_t i = 0; i < queueRows + 3; i++)
+        freeInputRows.Push(RowBuffer(m_wordsPerRow + 2));
+    for (std::size_t i = 0; i < queueRows + 1; i++)
+        freeOutputRows.Push(RowBuffer(m_wordsPerRow + 2));
+
+    std::atomic<bool> failed{ false };
+    auto fail = [&]()
+    {
+        failed = true;
+        freeInputRows.Close();
+        inputRows.Close();
+        freeOutputRows.Close();
+        outputRows.Close();
+    };
+
+    std::thread reader([&]()
+    {
+        auto row = RowBuffer();
+        for (int i = 0; i < m_height; i++)
+        {
+            if (!freeInputRows.Pop(row))
+                return;
+            if (!input.read(reinterpret_cast<char*>(row.data() + 1), rowBytes))
+            {
+                fail();
+                return;
+            }
+            row[m_wordsPerRow] &= m_lastWordMask;
+            if (!inputRows.Push(std::move(row)))
+                return;
+        }
+    });
+
+    std::thread writer([&]()
+    {
+        auto row = RowBuffer();
+        for (int i = 0; i < m_height; i++)
+        {
+            if (!outputRows.Pop(row))
+                return;
+            if (!output.write(reinterpret_cast<const char*>(row.data() + 1), rowBytes))
+            {
+                fail();
+                return;
+            }
+            if (!freeOutputRows.Push(std::move(row)))
+                return;
+        }
+        if (!output.flush())
+            fail();
+    });
+
+    // the window: the rows above, at and below the one being computed, zero rows past the edges
+    const auto zeros = RowBuffer(m_wordsPerRow + 2);
+    auto above = RowBuffer();
+    auto current = RowBuffer();
+    auto below = RowBuffer();
+    auto nextRow = RowBuffer();
+    auto population = std::uint64_t(0);
+    if (m_height > 0 && !inputRows.Pop(current))
+        fail();
+
+    for (int i = 0; !failed && i < m_height; i++)
+    {
+        if (i + 1 < m_height && !inputRows.Pop(below))
+            break;
+        if (!freeOutputRows.Pop(nextRow))
+            break;
+
+        const auto* aboveWords = i > 0 ? above.data() : zeros.data();
+        const auto* belowWords = i + 1 < m_height ? below.data() : zeros.data();
+        m_rowKernel(aboveWords + 1, current.data() + 1, belowWords + 1, nextRow.data() + 1, 0, m_wordsPerRow, m_rule);
+        nextRow[m_wordsPerRow] &= m_lastWordMask;
+        for (int word = 1; word <= m_wordsPerRow; word++)
+            population += BitKernels::PopCount(nextRow[word]);
+        if (!outputRows.Push(std::move(nextRow)))
+            break;
+
+        if (i > 0 && !freeInputRows.Push(std::move(above)))
+            break;
+        above = std::move(current);
+        current = std::move(below);
+    }
+
+    reader.join();
+    writer.join();
+    if (failed)
+        return false;
+
+    m_population = population;
+    return true;
+}
+
+bool GameOfLife_Streaming::Advance(const std::string& inputPath, const std::string& outputPath, int generations)
+{
+    // the writer truncates its file before the input is read
+    auto tempPath = outputPath + ".tmp";
+    if (generations < 1 || IsSameFile(inputPath, outputPath) || IsSameFile(inputPath, tempPath))
+        return false;
+
+    auto source = inputPath;
+    for (int generation = 1; generation <= generations; generation++)
+    {
+        auto target = (generations - generation) % 2 == 0 ? outputPath : tempPath;
+
+        // the input is only ever read front to back, a large buffer keeps the calls few; the
+        // output goes through the chunked writer
+        BufferedFile inputBuffer;
+        std::ifstream input;
+        input.rdbuf()->pubsetbuf(inputBuffer.buffer.get(), FileBufferBytes);
+        input.open(source, std::ios::binary);
+        FileWriterStream output(target);
+        if (!input || !output || !Step(input, output) || !output.Close())
+        {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+
+        source = target;
+    }
+
+    if (generations > 1)
+        std::remove(tempPath.c_str());
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <BitKernels.h>
+#include <Rule.h>
+
+// Out-of-core stepping for boards that fit in no memory tier: a generation is read row by row
+// from a stream and the next one written row by row to another, so the I/O is purely
+// sequential. Rows are in the packed layout of GameOfLife_BitPacked::WritePackedRows. A reader
+// thread, the computing caller and a writer thread are connected by bounded queues, and the
+// caller keeps only the rolling window of three rows a row's next generation depends on, so
+// memory stays at a few dozen rows whatever the height. Dead boundaries only.
+class GameOfLife_Streaming
+{
+public:
+    // queueRows is the capacity of each of the queues between the stages
+    GameOfLife_Streaming(int width, int height, int queueRows = 64);
+    GameOfLife_Streaming(const GameOfLife_Streaming&) = delete;
+    GameOfLife_Streaming& operator=(const GameOfLife_Streaming&) = delete;
+    GameOfLife_Streaming(GameOfLife_Streaming&&) = delete;
+    GameOfLife_Streaming& operator=(GameOfLife_Streaming&&) = delete;
+
+    void SetIsa(BitKernels::Isa isa);
+    void SetRule(const Rule& rule);
+    const Rule& GetRule() const
+    {
+        return m_rule;
+    }
+
+    // Reads Height() rows from input and writes their next generation to output. Returns false
+    // when input ends early or output fails.
+    bool Step(std::istream& input, std::ostream& output);
+    // Steps generations times from inputPath to outputPath. Intermediate generations alternate
+    // between outputPath and outputPath + ".tmp" so that the last one lands in outputPath; false
+    // when inputPath is either of those files, and the .tmp file is removed on failure too.
+    bool Advance(const std::string& inputPath, const std::string& outputPath, int generations);
+
+    // Of the generation written last.
+    std::uint64_t Population() const
+    {
+        return m_population;
+    }
+
+    int Width() const
+    {
+        return m_width;
+    }
+    int Height() const
+    {
+        return m_height;
+    }
+    int WordsPerRow() const
+    {
+        return m_wordsPerRow;
+    }
+
+private:
+    const int m_width;
+    const int m_height;
+    const int m_wordsPerRow;
+    const Word m_lastWordMask;
+    const int m_queueRows;
+    Rule m_rule = ConwayLife;
+    BitKernels::Isa m_isa = BitKernels::Isa::Scalar;
+    BitKernels::RowKernel m_rowKernel = nullptr;
+    std::uint64_t m_population = 0;
+};
@@ -0,0 +1,144 @@
+#include <MappedFile.h>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#if defined(_WIN32)
+bool MappedFile::Create(const std::string& path, std::size_t size)
+{
+    Close();
+    m_file = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        m_file = nullptr;
+        return false;
+    }
+    return Map(size, Access::ReadWrite);
+}
+
+bool MappedFile::Open(const std::string& path, Access access)
+{
+    Close();
+    auto readOnly = access == Access::ReadOnly;
+    m_file = ::CreateFileA(path.c_str(), readOnly ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE, readOnly ? FILE_SHARE_READ : 0, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        m_file = nullptr;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+    return Map(static_cast<std::size_t>(size.QuadPart), access);
+}
+
+// Creating the mapping extends the file to size, the new part reads as zeros.
+bool MappedFile::Map(std::size_t size, Access access)
+{
+    auto readOnly = access == Access::ReadOnly;
+    auto size64 = static_cast<unsigned long long>(size);
+    m_mapping = ::CreateFileMappingA(m_file, nullptr, readOnly ? PAGE_READONLY : PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), nullptr);
+    if (m_mapping)
+        m_data = ::MapViewOfFile(m_mapping, readOnly ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!m_data)
+    {
+        Close();
+        return false;
+    }
+    m_size = size;
+    return true;
+}
+
+bool MappedFile::Sync()
+{
+    return m_data && ::FlushViewOfFile(m_data, 0) && ::FlushFileBuffers(m_file);
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+        ::UnmapViewOfFile(m_data);
+    if (m_mapping)
+        ::CloseHandle(m_mapping);
+    if (m_file)
+        ::CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+#else
+bool MappedFile::Create(const std::string& path, std::size_t size)
+{
+    Close();
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    // the file is sparse until the board is written
+    if (m_fd < 0 || ::ftruncate(m_fd, static_cast<off_t>(size)) != 0)
+    {
+        Close();
+        return false;
+    }
+    return Map(size, Access::ReadWrite);
+}
+
+bool MappedFile::Open(const std::string& path, Access access)
+{
+    Close();
+    m_fd = ::open(path.c_str(), access == Access::ReadOnly ? O_RDONLY : O_RDWR);
+    struct stat status;
+    if (m_fd < 0 || ::fstat(m_fd, &status) != 0 || status.st_size == 0)
+    {
+        Close();
+        return false;
+    }
+    return Map(static_cast<std::size_t>(status.st_size), access);
+}
+
+bool MappedFile::Map(std::size_t size, Access access)
+{
+    auto protection = access == Access::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    auto* data = ::mmap(nullptr, size, protection, MAP_SHARED, m_fd, 0);
+    if (data == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    // generations are read and written front to back, so read-ahead pays off
+    ::posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+bool MappedFile::Sync()
+{
+    return m_data && ::msync(m_data, m_size, MS_SYNC) == 0;
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+        ::munmap(m_data, m_size);
+    if (m_fd >= 0)
+        ::close(m_fd);
+    m_data = nullptr;
+    m_fd = -1;
+    m_size = 0;
+}
+#endif
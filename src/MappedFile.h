@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-write shared mapping of a whole file; changes reach the file through the page cache.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+    ~MappedFile();
+
+    enum class Access
+    {
+        ReadWrite,
+        ReadOnly,   // Data() must not be written through
+    };
+
+    // Creates path or truncates it, sizes it to size bytes, all zero, and maps it.
+    bool Create(const std::string& path, std::size_t size);
+    // Maps an existing file.
+    bool Open(const std::string& path, Access access = Access::ReadWrite);
+    // Blocks until the mapped pages are written to the file.
+    bool Sync();
+    void Close();
+
+    bool IsOpen() const
+    {
+        return m_data != nullptr;
+    }
+    void* Data() const
+    {
+        return m_data;
+    }
+    std::size_t Size() const
+    {
+        return m_size;
+    }
+
+private:
+    bool Map(std::size_t size, Access access);
+
+#if defined(_WIN32)
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+};
@@ -0,0 +1,60 @@
+#include <Partitioning.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+std::vector<int> SplitRange(int length, int nrParts, int alignment)
+{
+    alignment = std::max(alignment, 1);
+    auto nrUnits = (length + alignment - 1) / alignment;
+    auto unitsPerPart = nrUnits / nrParts;
+    auto remainder = nrUnits % nrParts;
+
+    auto boundaries = std::vector<int>(nrParts + 1);
+    auto unit = 0;
+    for (int part = 0; part < nrParts; part++)
+    {
+        boundaries[part] = std::min(unit * alignment, length);
+        unit += unitsPerPart + (part < remainder ? 1 : 0);
+    }
+    boundaries[nrParts] = length;
+    return boundaries;
+}
+
+std::vector<Region> PartitionBoard(int nrRows, int nrCols, int nrParts, PartitionStrategy strategy, int alignment)
+{
+    auto gridRows = nrParts;
+    auto gridCols = 1;
+    if (strategy == PartitionStrategy::Tiles)
+    {
+        // the factorization whose tiles have the aspect ratio closest to 1
+        auto bestSkew = std::numeric_limits<double>::infinity();
+        for (int rows = 1; rows <= nrParts; rows++)
+        {
+            if (nrParts % rows)
+                continue;
+
+            auto cols = nrParts / rows;
+            auto skew = std::fabs(std::log((double(nrRows) / rows) / (double(nrCols) / cols)));
+            if (skew < bestSkew)
+            {
+                bestSkew = skew;
+                gridRows = rows;
+                gridCols = cols;
+            }
+        }
+    }
+
+    auto rowBoundaries = SplitRange(nrRows, gridRows, alignment);
+    auto colBoundaries = SplitRange(nrCols, gridCols, alignment);
+
+    auto regions = std::vector<Region>();
+    regions.reserve(nrParts);
+    for (int i = 0; i < gridRows; i++)
+    {
+        for (int j = 0; j < gridCols; j++)
+            regions.push_back(Region{ rowBoundaries[i], rowBoundaries[i + 1], colBoundaries[j], colBoundaries[j + 1] });
+    }
+    return regions;
+}
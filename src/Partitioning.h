@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+// Half-open rectangle of board cells.
+struct Region
+{
+    int startRow;
+    int endRow;
+    int startCol;
+    int endCol;
+
+    bool Empty() const
+    {
+        return startRow >= endRow || startCol >= endCol;
+    }
+};
+
+enum class PartitionStrategy
+{
+    RowBands,   // full-width bands of rows
+    Tiles,      // 2D grid, as close to square tiles as the part count allows
+};
+
+// Splits [0, length) into nrParts consecutive ranges and returns the nrParts + 1 boundaries.
+// Inner boundaries are multiples of alignment; the leftover units go one each to the first ranges,
+// so sizes differ by at most one alignment unit. Ranges are empty when there are fewer units than parts.
+std::vector<int> SplitRange(int length, int nrParts, int alignment = 1);
+
+// Splits an nrRows x nrCols board into exactly nrParts regions, some possibly empty.
+std::vector<Region> PartitionBoard(int nrRows, int nrCols, int nrParts, PartitionStrategy strategy, int alignment = 1);
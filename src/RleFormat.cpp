@@ -0,0 +1,314 @@
+#include <RleFormat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int BitsPerWord = GameOfLife_BitPacked::BitsPerWord;
+    constexpr std::size_t ChunkBytes = std::size_t(1) << 16;
+    constexpr std::size_t MaxLineLength = 70;   // what Golly writes, some readers rely on it
+
+    std::string Trim(const std::string& text)
+    {
+        auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            return std::string();
+        auto last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+
+    bool ParseCount(const std::string& text, int& value)
+    {
+        if (text.empty() || !std::all_of(text.begin(), text.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }))
+            return false;
+        auto parsed = std::strtoll(text.c_str(), nullptr, 10);
+        if (parsed > 1000000000)
+            return false;
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    // Sets bits [first, first + count) of a row.
+    void SetBits(Word* words, int first, int count)
+    {
+        auto end = first + count;
+        while (first < end)
+        {
+            auto bit = first % BitsPerWord;
+            auto length = std::min(BitsPerWord - bit, end - first);
+            auto mask = length == BitsPerWord ? ~Word(0) : ((Word(1) << length) - 1) << bit;
+            words[first / BitsPerWord] |= mask;
+            first += length;
+        }
+    }
+
+    // Index of the first cell at or after from that is alive (or dead), width when there is none.
+    int FindCell(const Word* words, int wordsPerRow, int width, int from, bool alive)
+    {
+        if (from >= width)
+            return width;
+
+        auto index = from / BitsPerWord;
+        auto word = (alive ? words[index] : ~words[index]) & (~Word(0) << (from % BitsPerWord));
+        while (word == 0)
+        {
+            if (++index == wordsPerRow)
+                return width;
+            word = alive ? words[index] : ~words[index];
+        }
+        return std::min(index * BitsPerWord + BitKernels::LowestBitIndex(word), width);
+    }
+
+    class ChunkReader
+    {
+    public:
+        explicit ChunkReader(std::istream& in) :
+            m_in(in),
+            m_buffer(ChunkBytes)
+        {
+        }
+
+        // the next character, or -1 at the end of the stream
+        int Next()
+        {
+            if (m_position == m_end)
+            {
+                m_in.read(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+                m_end = static_cast<std::size_t>(m_in.gcount());
+                m_position = 0;
+                if (m_end == 0)
+                    return -1;
+            }
+            return static_cast<unsigned char>(m_buffer[m_position++]);
+        }
+
+    private:
+        std::istream& m_in;
+        std::vector<char> m_buffer;
+        std::size_t m_position = 0;
+        std::size_t m_end = 0;
+    };
+
+    class ChunkWriter
+    {
+    public:
+        explicit ChunkWriter(std::ostream& out) :
+            m_out(out)
+        {
+            m_chunk.reserve(ChunkBytes + 64);
+        }
+
+        void Write(const std::string& text)
+        {
+            m_chunk += text;
+            if (m_chunk.size() >= ChunkBytes)
+                Flush();
+        }
+
+        // one run, wrapping lines before they get too long
+        void WriteRun(int count, char tag)
+        {
+            char token[16];
+            auto length = std::size_t(0);
+            if (count > 1)
+            {
+                char digits[12];
+                auto nrDigits = 0;
+                for (; count > 0; count /= 10)
+                    digits[nrDigits++] = static_cast<char>('0' + count % 10);
+                while (nrDigits > 0)
+                    token[length++] = digits[--nrDigits];
+            }
+            token[length++] = tag;
+
+            if (m_lineLength + length > MaxLineLength)
+            {
+                m_chunk += '\n';
+                m_lineLength = 0;
+            }
+            m_lineLength += length;
+            m_chunk.append(token, length);
+            if (m_chunk.size() >= ChunkBytes)
+                Flush();
+        }
+
+        bool Flush()
+        {
+            m_out.write(m_chunk.data(), static_cast<std::streamsize>(m_chunk.size()));
+            m_chunk.clear();
+            return static_cast<bool>(m_out);
+        }
+
+    private:
+        std::ostream& m_out;
+        std::string m_chunk;
+        std::size_t m_lineLength = 0;
+    };
+}
+
+bool ReadRleHeader(std::istream& in, RleHeader& header)
+{
+    auto line = std::string();
+    while (std::getline(in, line))
+    {
+        line = Trim(line);
+        if (!line.empty() && line.front() != '#')
+            break;
+        line.clear();
+    }
+    if (line.empty())
+        return false;
+
+    auto parsed = RleHeader();
+    auto hasWidth = false;
+    auto hasHeight = false;
+    std::size_t start = 0;
+    while (start <= line.size())
+    {
+        auto equals = line.find('=', start);
+        if (equals == std::string::npos)
+            return false;
+        auto key = Trim(line.substr(start, equals - start));
+        // the rule runs to the end of the line, Golly appends bounded grids as ":T100,100"
+        auto end = key == "rule" ? line.size() : std::min(line.find(',', equals), line.size());
+        auto value = Trim(line.substr(equals + 1, end - equals - 1));
+        start = end + 1;
+
+        if (key == "x")
+            hasWidth = ParseCount(value, parsed.width);
+        else if (key == "y")
+            hasHeight = ParseCount(value, parsed.height);
+        else if (key == "rule")
+            parsed.hasRule = ParseRule(value.substr(0, value.find(':')), parsed.rule);
+    }
+    if (!hasWidth || !hasHeight)
+        return false;
+
+    header = parsed;
+    return true;
+}
+
+bool ReadRleCells(std::istream& in, GameOfLife_BitPacked& gol, int x, int y)
+{
+    if (x < 0 || y < 0)
+        return false;
+
+    // runs go into a copy of the current row, which is written back once the row is finished
+    auto reader = ChunkReader(in);
+    auto rowWords = std::vector<Word>(gol.WordsPerRow());
+    auto row = x;
+    auto col = y;
+    auto rowLoaded = false;
+    auto count = 0;
+    constexpr int MaxCount = 1000000000;
+
+    auto finishRow = [&]()
+    {
+        if (rowLoaded)
+            gol.SetRow(row, rowWords.data());
+        rowLoaded = false;
+    };
+
+    for (auto c = reader.Next(); c != -1; c = reader.Next())
+    {
+        if (c >= '0' && c <= '9')
+        {
+            if (count > (MaxCount - (c - '0')) / 10)
+                return false;
+            count = count * 10 + (c - '0');
+            continue;
+        }
+        if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+            continue;
+
+        auto runLength = count == 0 ? 1 : count;
+        count = 0;
+        // row and col never pass the board's size, so runs are checked against what is left
+        if (c == 'b' || c == '.')
+        {
+            if (runLength > gol.Width() - col)
+                return false;
+            col += runLength;
+        }
+        else if (c == '$')
+        {
+            finishRow();
+            if (runLength > gol.Height() - row)
+                return false;
+            row += runLength;
+            col = y;
+        }
+        else if (c == '!')
+        {
+            break;
+        }
+        else if (c == 'o' || (c >= 'A' && c <= 'X') || (c >= 'p' && c <= 'y'))
+        {
+            // multi-state cells count as alive; states above 24 are a prefix p to y and a letter
+            if (c >= 'p' && c <= 'y')
+            {
+                auto state = reader.Next();
+                if (state < 'A' || state > 'X')
+                    return false;
+            }
+            if (row >= gol.Height() || runLength > gol.Width() - col)
+                return false;
+            if (!rowLoaded)
+            {
+                std::copy_n(gol.GetRow(row), rowWords.size(), rowWords.begin());
+                rowLoaded = true;
+            }
+            SetBits(rowWords.data(), col, runLength);
+            col += runLength;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (col > gol.Width())
+            return false;
+    }
+
+    finishRow();
+    return true;
+}
+
+bool WriteRle(std::ostream& out, const GameOfLife_BitPacked& gol)
+{
+    auto writer = ChunkWriter(out);
+    writer.Write("x = " + std::to_string(gol.Width()) + ", y = " + std::to_string(gol.Height()) + ", rule = " + RuleToString(gol.GetRule()) + "\n");
+
+    // row ends are held back until the next live cell, so trailing empty rows are never written
+    auto pendingRowEnds = 0;
+    for (int i = 0; i < gol.Height(); i++)
+    {
+        const auto* words = gol.GetRow(i);
+        auto position = 0;
+        while (true)
+        {
+            auto alive = FindCell(words, gol.WordsPerRow(), gol.Width(), position, true);
+            if (alive == gol.Width())
+                break;
+            auto dead = FindCell(words, gol.WordsPerRow(), gol.Width(), alive, false);
+
+            if (pendingRowEnds > 0)
+                writer.WriteRun(pendingRowEnds, '$');
+            pendingRowEnds = 0;
+            if (alive > position)
+                writer.WriteRun(alive - position, 'b');
+            writer.WriteRun(dead - alive, 'o');
+            position = dead;
+        }
+        pendingRowEnds++;
+    }
+
+    writer.Write("!\n");
+    return writer.Flush();
+}
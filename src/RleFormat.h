@@ -0,0 +1,27 @@
+#pragma once
+
+#include <iosfwd>
+#include <ImplGameOfLife_BitPacked.h>
+#include <Rule.h>
+
+// Run-length encoded patterns as used by Golly and the LifeWiki: '#' comment lines, a header
+// line "x = <width>, y = <height>, rule = B3/S23", then runs of dead (b) and alive (o) cells
+// with row ends ($), closed by '!'. Multi-state patterns are read with every live state alive.
+// Runs are decoded straight into the words of a bit-packed board and encoded by scanning its
+// words, so neither direction builds a per-cell structure.
+struct RleHeader
+{
+    int width = 0;
+    int height = 0;
+    Rule rule = ConwayLife;
+    bool hasRule = false;
+};
+
+// Reads the comments and the header line, leaving in at the first run, so that a board of
+// the right size can be created before ReadRleCells.
+bool ReadRleHeader(std::istream& in, RleHeader& header);
+// Decodes the runs that follow the header with the top left cell at (x, y). Live cells are
+// added to the board; false when the pattern is malformed or does not fit.
+bool ReadRleCells(std::istream& in, GameOfLife_BitPacked& gol, int x = 0, int y = 0);
+
+bool WriteRle(std::ostream& out, const GameOfLife_BitPacked& gol);
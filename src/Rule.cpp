@@ -0,0 +1,73 @@
+#include <Rule.h>
+
+#include <cctype>
+
+namespace
+{
+    bool ParseDigits(const std::string& text, std::uint16_t& mask)
+    {
+        mask = 0;
+        for (auto c : text)
+        {
+            if (c < '0' || c > '8')
+                return false;
+            mask |= 1 << (c - '0');
+        }
+        return true;
+    }
+}
+
+bool ParseRule(const std::string& text, Rule& rule)
+{
+    auto separator = text.find('/');
+    if (separator == std::string::npos)
+        return false;
+
+    auto first = text.substr(0, separator);
+    auto second = text.substr(separator + 1);
+    auto prefix = [](const std::string& part) { return part.empty() ? '\0' : static_cast<char>(std::toupper(part.front())); };
+
+    std::string birth;
+    std::string survival;
+    if (prefix(first) == 'B' && prefix(second) == 'S')
+    {
+        birth = first.substr(1);
+        survival = second.substr(1);
+    }
+    else if (prefix(first) == 'S' && prefix(second) == 'B')
+    {
+        survival = first.substr(1);
+        birth = second.substr(1);
+    }
+    else
+    {
+        survival = first;
+        birth = second;
+    }
+
+    auto parsed = Rule{ 0, 0 };
+    if (!ParseDigits(birth, parsed.birth) || !ParseDigits(survival, parsed.survival))
+        return false;
+    if (parsed.birth & 1)
+        return false;
+
+    rule = parsed;
+    return true;
+}
+
+std::string RuleToString(const Rule& rule)
+{
+    auto text = std::string("B");
+    for (int n = 0; n <= 8; n++)
+    {
+        if ((rule.birth >> n) & 1)
+            text += static_cast<char>('0' + n);
+    }
+    text += "/S";
+    for (int n = 0; n <= 8; n++)
+    {
+        if ((rule.survival >> n) & 1)
+            text += static_cast<char>('0' + n);
+    }
+    return text;
+}
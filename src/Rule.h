@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Outer totalistic rule: bit n of birth/survival is set when a dead/alive cell
+// with n alive neighbours is alive in the next generation.
+struct Rule
+{
+    std::uint16_t birth;
+    std::uint16_t survival;
+
+    constexpr bool IsAliveNextGeneration(bool alive, int nrAliveNeighbors) const
+    {
+        return ((alive ? survival : birth) >> nrAliveNeighbors) & 1;
+    }
+
+    constexpr bool operator==(const Rule& other) const
+    {
+        return birth == other.birth && survival == other.survival;
+    }
+    constexpr bool operator!=(const Rule& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+inline constexpr Rule ConwayLife = { 1 << 3, 1 << 2 | 1 << 3 };
+inline constexpr Rule HighLife = { 1 << 3 | 1 << 6, 1 << 2 | 1 << 3 };
+inline constexpr Rule DayAndNight = { 1 << 3 | 1 << 6 | 1 << 7 | 1 << 8, 1 << 3 | 1 << 4 | 1 << 6 | 1 << 7 | 1 << 8 };
+inline constexpr Rule Seeds = { 1 << 2, 0 };
+
+// Rules with compile-time specialized kernels, see BitKernels::SelectRowKernel.
+inline constexpr std::array<Rule, 4> BuiltinRules = { ConwayLife, HighLife, DayAndNight, Seeds };
+
+// Accepts "B36/S23", "S23/B36" and the classic "23/36" survival/birth notation.
+// Rules with B0 are rejected, the engines assume empty space stays empty.
+bool ParseRule(const std::string& text, Rule& rule);
+std::string RuleToString(const Rule& rule);
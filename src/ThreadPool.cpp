@@ -0,0 +1,141 @@
+#include <ThreadPool.h>
+
+#include <algorithm>
+
+namespace
+{
+    thread_local const ThreadPool* t_pool = nullptr;
+    thread_local int t_workerIdx = -1;
+}
+
+ThreadPool::ThreadPool(int nrThreads)
+{
+    if (nrThreads <= 0)
+        nrThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int i = 0; i < nrThreads; i++)
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+
+    for (int i = 0; i < nrThreads; i++)
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_taskAvailable.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::Submit(Task task)
+{
+    auto queueIdx = t_pool == this ? t_workerIdx : static_cast<int>(m_nextQueue++ % m_queues.size());
+
+    m_nrPending++;
+    {
+        auto& queue = *m_queues[queueIdx];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    m_nrQueued++;
+
+    {
+        // pairs with the predicate check of sleeping workers, so the notification cannot be lost
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_taskAvailable.notify_one();
+}
+
+bool ThreadPool::TryPop(int queueIdx, Task& task)
+{
+    auto& queue = *m_queues[queueIdx];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+        return false;
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    m_nrQueued--;
+    return true;
+}
+
+bool ThreadPool::TrySteal(int thiefIdx, Task& task)
+{
+    auto nrQueues = static_cast<int>(m_queues.size());
+    for (int i = 1; i <= nrQueues; i++)
+    {
+        auto& queue = *m_queues[(thiefIdx + i) % nrQueues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty())
+            continue;
+
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        m_nrQueued--;
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::TryGetTask(int queueIdx, Task& task)
+{
+    if (m_nrQueued == 0)
+        return false;
+    if (queueIdx >= 0 && TryPop(queueIdx, task))
+        return true;
+    return TrySteal(std::max(queueIdx, 0), task);
+}
+
+void ThreadPool::RunTask(Task& task)
+{
+    task();
+    task = nullptr;
+
+    if (--m_nrPending == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_allDone.notify_all();
+    }
+}
+
+void ThreadPool::WorkerLoop(int workerIdx)
+{
+    t_pool = this;
+    t_workerIdx = workerIdx;
+
+    auto task = Task();
+    while (true)
+    {
+        if (TryGetTask(workerIdx, task))
+        {
+            RunTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_taskAvailable.wait(lock, [this]() { return m_stop || m_nrQueued > 0; });
+        if (m_stop && m_nrQueued == 0)
+            return;
+    }
+}
+
+void ThreadPool::Wait()
+{
+    auto queueIdx = t_pool == this ? t_workerIdx : -1;
+    auto task = Task();
+    while (m_nrPending > 0)
+    {
+        if (TryGetTask(queueIdx, task))
+        {
+            RunTask(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_allDone.wait(lock, [this]() { return m_nrPending == 0 || m_nrQueued > 0; });
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Long-lived workers, each with its own task deque. A worker pops its newest task
+// first and, when its deque is empty, steals the oldest task of another worker.
+// Tasks submitted from inside a task go to the submitting worker's deque.
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    // nrThreads <= 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(int nrThreads = 0);
+    ~ThreadPool();
+
+    int NrThreads() const
+    {
+        return static_cast<int>(m_threads.size());
+    }
+
+    void Submit(Task task);
+
+    // Runs queued tasks on the calling thread until every submitted task, including
+    // the ones submitted by other tasks, has finished. Not to be called from inside a task.
+    void Wait();
+
+    template<class F>
+    void ParallelFor(int nrTasks, F&& function)
+    {
+        for (int i = 0; i < nrTasks; i++)
+        {
+            Submit([&function, i]() { function(i); });
+        }
+        Wait();
+    }
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool TryPop(int queueIdx, Task& task);
+    bool TrySteal(int thiefIdx, Task& task);
+    bool TryGetTask(int queueIdx, Task& task);
+    void RunTask(Task& task);
+    void WorkerLoop(int workerIdx);
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::atomic<int> m_nrQueued{ 0 };
+    std::atomic<int> m_nrPending{ 0 };
+    std::atomic<unsigned> m_nextQueue{ 0 };
+    bool m_stop = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_allDone;
+};
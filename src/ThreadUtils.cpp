@@ -0,0 +1,131 @@
+#include <ThreadUtils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace
+{
+    inline void CpuRelax()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+#if !defined(__linux__) && !defined(_WIN32)
+    std::mutex g_phaseMutex;
+    std::condition_variable g_phaseChanged;
+#endif
+
+    // Sleeps while word still holds expected; may return spuriously.
+    void SleepWhileEqual(std::atomic<std::uint32_t>& word, std::uint32_t expected)
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+        WaitOnAddress(&word, &expected, sizeof(expected), INFINITE);
+#else
+        std::unique_lock<std::mutex> lock(g_phaseMutex);
+        g_phaseChanged.wait(lock, [&]() { return word.load() != expected; });
+#endif
+    }
+
+    void WakeAll(std::atomic<std::uint32_t>& word)
+    {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+        WakeByAddressAll(&word);
+#else
+        (void)word;
+        {
+            std::lock_guard<std::mutex> lock(g_phaseMutex);
+        }
+        g_phaseChanged.notify_all();
+#endif
+    }
+}
+
+SpinBarrier::SpinBarrier(int nrThreads, int spinCount)
+    : m_nrThreads(nrThreads)
+    // with more threads than cores a spinning waiter only delays the threads it waits for
+    , m_spinCount(static_cast<unsigned>(nrThreads) <= std::thread::hardware_concurrency() ? spinCount : 0)
+    , m_remaining(nrThreads)
+    , m_stats(nrThreads)
+{
+}
+
+void SpinBarrier::Wait(int threadIdx)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto& stats = m_stats[threadIdx].stats;
+    auto phase = m_phase.load(std::memory_order_acquire);
+
+    if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // nobody can arrive for the next round before the phase moves on, so the reset is safe here
+        m_remaining.store(m_nrThreads, std::memory_order_relaxed);
+        m_phase.fetch_add(1, std::memory_order_seq_cst);
+        if (m_nrSleepers.load(std::memory_order_seq_cst) > 0)
+            WakeAll(m_phase);
+    }
+    else
+    {
+        auto spins = 0;
+        while (m_phase.load(std::memory_order_acquire) == phase && spins < m_spinCount)
+        {
+            CpuRelax();
+            spins++;
+        }
+
+        if (m_phase.load(std::memory_order_acquire) == phase)
+        {
+            stats.nrSleeps++;
+            m_nrSleepers.fetch_add(1, std::memory_order_seq_cst);
+            while (m_phase.load(std::memory_order_seq_cst) == phase)
+                SleepWhileEqual(m_phase, phase);
+            m_nrSleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    stats.nrWaits++;
+    stats.totalNanoseconds += elapsed;
+    stats.maxNanoseconds = std::max(stats.maxNanoseconds, elapsed);
+}
+
+void SpinBarrier::ResetStats()
+{
+    for (auto& slot : m_stats)
+        slot.stats = WaitStats();
+}
+
+void SpinBarrier::PrintStats(std::ostream& out) const
+{
+    for (int i = 0; i < m_nrThreads; i++)
+    {
+        const auto& stats = m_stats[i].stats;
+        auto average = stats.nrWaits ? stats.totalNanoseconds / stats.nrWaits : 0;
+        out << "thread " << i << ": " << stats.nrWaits << " waits, " << stats.nrSleeps << " slept, "
+            << stats.totalNanoseconds / 1000 << " us total, " << average << " ns average, " << stats.maxNanoseconds << " ns max\n";
+    }
+}
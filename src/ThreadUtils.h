@@ -1,8 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
 #include <iostream>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 
 class Semaphore {
 public:
@@ -19,8 +23,10 @@ public:
     }
 
     inline void notify(int n) {
+        std::unique_lock<std::mutex> lock(mtx);
+        count += n;
         for (int i = 0; i < n; i++)
-            notify();
+            cv.notify_one();
     }
 
     inline void wait() {
@@ -81,3 +87,111 @@ private:
     Semaphore turnstile1 = Semaphore(0);
     Semaphore turnstile2 = Semaphore(0);
 };
+
+// Barrier for a fixed set of threads that reuses itself every round. Arrival is a single atomic
+// decrement; the last thread to arrive resets the count and advances the phase, which flips the
+// sense the others wait on. Waiters spin for a bounded number of checks and then sleep on the
+// phase word (futex on Linux, WaitOnAddress on Windows, a condition variable elsewhere).
+class SpinBarrier
+{
+public:
+    struct WaitStats
+    {
+        std::uint64_t nrWaits = 0;
+        std::uint64_t nrSleeps = 0;     // waits that ran out of spins and went to the kernel
+        std::uint64_t totalNanoseconds = 0;
+        std::uint64_t maxNanoseconds = 0;
+    };
+
+    SpinBarrier(const SpinBarrier&) = delete;
+    SpinBarrier& operator=(const SpinBarrier&) = delete;
+    SpinBarrier(SpinBarrier&&) = delete;
+    SpinBarrier& operator=(SpinBarrier&&) = delete;
+
+    // spinning is disabled when there are more threads than hardware threads
+    explicit SpinBarrier(int nrThreads, int spinCount = 4096);
+
+    // threadIdx in [0, nrThreads) picks the slot the wait is recorded in
+    void Wait(int threadIdx);
+
+    int NrThreads() const
+    {
+        return m_nrThreads;
+    }
+
+    const WaitStats& Stats(int threadIdx) const
+    {
+        return m_stats[threadIdx].stats;
+    }
+    void ResetStats();
+    void PrintStats(std::ostream& out) const;
+
+private:
+    // one cache line per thread so recording a wait does not invalidate the others' slots
+    struct alignas(64) PaddedStats
+    {
+        WaitStats stats;
+    };
+
+    const int m_nrThreads;
+    const int m_spinCount;
+    alignas(64) std::atomic<int> m_remaining;
+    alignas(64) std::atomic<std::uint32_t> m_phase{ 0 };
+    std::atomic<int> m_nrSleepers{ 0 };
+    std::vector<PaddedStats> m_stats;
+};
+
+// Blocking FIFO of at most capacity items between pipeline stages. Close wakes everybody: pushes
+// fail from then on and pops fail once the queue has drained.
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacity) :
+        m_capacity(capacity)
+    {
+    }
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+    BoundedQueue(BoundedQueue&&) = delete;
+    BoundedQueue& operator=(BoundedQueue&&) = delete;
+
+    bool Push(T item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [&] { return m_closed || m_items.size() < m_capacity; });
+        if (m_closed)
+            return false;
+        m_items.push_back(std::move(item));
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    bool Pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [&] { return m_closed || !m_items.empty(); });
+        if (m_items.empty())
+            return false;
+        item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    void Close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+private:
+    const std::size_t m_capacity;
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::deque<T> m_items;
+    bool m_closed = false;
+};
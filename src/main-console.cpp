@@ -2,10 +2,22 @@
 #include <thread>
 #include <vector>
 #include <chrono>
+#include <fstream>
 #include <random>
+#include <string>
 
+#include <Checkpoint.h>
+#include <FileWriter.h>
 #include <ImplGameOfLife.h>
 #include <ImplGameOfLife_Contiguous.h>
+#include <ImplGameOfLife_BitPacked.h>
+#include <ImplGameOfLife_Distributed.h>
+#include <ImplGameOfLife_HashLife.h>
+#include <ImplGameOfLife_Sparse.h>
+#include <ImplGameOfLife_Streaming.h>
+#include <Partitioning.h>
+#include <RleFormat.h>
+#include <ThreadPool.h>
 #include <ThreadUtils.h>
 
 #include <TestUtils.h>
@@ -16,10 +28,11 @@ static Semaphore t2(2);
 static int count = 0;
 static int n = 2;
 
-static auto boardSize = 40000;
+static auto boardWidth = 40000;
+static auto boardHeight = 40000;
 static auto numGenerations = 1;
 
-static Barrier barrier(boardSize);
+static Barrier barrier(boardHeight);
 
 void barrierRow(GameOfLife& gol, int row)
 {
@@ -39,16 +52,16 @@ std::vector<std::vector<bool>>& InitialBoard()
 
     std::uniform_int_distribution<int> distribution(0, 1);
 
-    static auto initialBoard = std::vector<std::vector<bool>>(boardSize);
+    static auto initialBoard = std::vector<std::vector<bool>>(boardHeight);
     static auto isInit = false;
     if (!isInit)
     {
         for (auto& row : initialBoard)
-            row.resize(boardSize);
+            row.resize(boardWidth);
 
-        for (int i = 0; i < boardSize; ++i)
+        for (int i = 0; i < boardHeight; ++i)
         {
-            for (int j = 0; j < boardSize; ++j)
+            for (int j = 0; j < boardWidth; ++j)
                 initialBoard[i][j] = static_cast<bool>(distribution(generator));
         }
         isInit = true;
@@ -67,73 +80,362 @@ State GenericImplementation(GameOfLife& gol)
     return gol.GetState();
 }
 
-State MainThreadOneRow(GameOfLife& gol)
+State FrontierImplementation(GameOfLife& gol)
 {
     gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    auto stateChanges = StateChanges();
+    for (int generation = 0; generation < numGenerations; generation++)
+    {
+        stateChanges = generation == 0 ? gol.GenNextStateChanges() : gol.GenNextStateChanges(stateChanges);
+        gol.DoStateChanges(stateChanges);
+    }
+    auto elapsed = timer.Elapsed();
+    std::cout << "main thread time, frontier: " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
 
+State BitPackedImplementation(GameOfLife_BitPacked& gol)
+{
+    gol.SetInitialState(InitialBoard());
     TestUtils::Timer timer;
-    timer.Reset();
-    auto stateChanges = std::vector<StateChanges>();
     for (int generation = 0; generation < numGenerations; generation++)
+        gol.DoStateChanges(gol.GenNextStateChanges());
+    auto elapsed = timer.Elapsed();
+    std::cout << "main thread time, bit packed implementation (" << BitKernels::IsaName(gol.GetIsa()) << "): " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+State DoubleBufferedImplementation(GameOfLife& gol)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step();
+    auto elapsed = timer.Elapsed();
+    std::cout << "main thread time, double buffered: " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+State BitPackedDoubleBuffered(GameOfLife_BitPacked& gol)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step();
+    auto elapsed = timer.Elapsed();
+    std::cout << "main thread time, bit packed double buffered (" << BitKernels::IsaName(gol.GetIsa()) << "): " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+// Unbounded universe, so cells that would die at the edge of the other engines' boards survive here.
+State HashLifeImplementation(GameOfLife_HashLife& gol)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    gol.Advance(numGenerations);
+    auto elapsed = timer.Elapsed();
+    std::cout << "hashlife time: " << elapsed << " milliseconds, " << gol.NrNodes() << " nodes\n";
+    return gol.GetState(0, 0, boardHeight, boardWidth);
+}
+
+// Saves the advanced universe as a macrocell file, loads it back and rasterizes the board's region
+// into the bit-packed engine.
+State HashLifeMacrocell(GameOfLife_HashLife& gol, GameOfLife_BitPacked& dense, const std::string& path)
+{
+    gol.SetInitialState(InitialBoard());
+    gol.Advance(numGenerations);
+    TestUtils::Timer timer;
     {
-        for (int row = 0; row < boardSize; row++)
-        {
-            stateChanges.push_back(gol.GenNextStateChangesForRow(row));
-        }
+        FileWriterStream out(path);
+        gol.WriteMacrocell(out);
+    }
 
-        for (const auto& stateChange : stateChanges)
-            gol.DoStateChanges(stateChange);
+    auto loaded = GameOfLife_HashLife();
+    std::ifstream in(path, std::ios::binary);
+    if (!loaded.ReadMacrocell(in))
+        std::cout << "invalid macrocell file " << path << "\n";
+    loaded.RasterizeRegion(dense, 0, 0);
+    auto elapsed = timer.Elapsed();
+    std::cout << "macrocell round trip through " << path << " and rasterize: " << elapsed << " milliseconds\n";
+    return dense.GetState();
+}
 
-        stateChanges.clear();
+// Unbounded as well, the state is cut to the board for comparisons with HashLife.
+State SparseImplementation(GameOfLife_Sparse& gol, ThreadPool& pool)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step(pool);
+    auto elapsed = timer.Elapsed();
+    std::cout << pool.NrThreads() << " pool threads time, sparse chunks: " << elapsed << " milliseconds, " << gol.NrChunks() << " chunks\n";
+    return gol.GetState(0, 0, boardHeight, boardWidth);
+}
+
+State DistributedImplementation(GameOfLife_Distributed& gol)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    if (!gol.Advance(numGenerations))
+        std::cout << "distributed run failed\n";
+    auto elapsed = timer.Elapsed();
+    std::cout << gol.NrWorkers() << " processes time, " << HaloTransportName(gol.Transport()) << " halos: " << elapsed
+              << " milliseconds, population " << (gol.Stats().empty() ? 0 : gol.Stats().back().population) << "\n";
+    return gol.GetState();
+}
+
+// The board stays in the file afterwards, so gol should not be shared with the other drivers.
+State BitPackedMapped(GameOfLife_BitPacked& gol, const std::string& path)
+{
+    gol.SetInitialState(InitialBoard());
+    if (!gol.MapToFile(path))
+    {
+        std::cout << "could not map " << path << "\n";
+        return gol.GetState();
     }
+
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step();
+    gol.SyncMappedFile();
     auto elapsed = timer.Elapsed();
-    std::cout << "main thread time, one row at a time: " << elapsed << " milliseconds\n";
+    std::cout << "main thread time, bit packed mapped to " << path << ": " << elapsed << " milliseconds\n";
     return gol.GetState();
 }
 
-void barrierTwo(GameOfLife& gol, int compIdx)
+// The board only exists in the files; gol is used to write the first generation and read the last one.
+State StreamingImplementation(GameOfLife_BitPacked& gol, const std::string& inputPath, const std::string& outputPath)
 {
-    static Barrier BarrierHalf(2);
-    for (auto generation = 0; generation < numGenerations; generation++)
+    gol.SetInitialState(InitialBoard());
     {
-        auto stateChange = gol.GenNextStateChanges<2>(compIdx);
-        BarrierHalf.phase1();
-        stateChangeMutex.wait();
-        gol.DoStateChanges(stateChange);
-        stateChangeMutex.notify();
-        BarrierHalf.phase2();
+        FileWriterStream input(inputPath);
+        gol.WritePackedRows(input);
     }
+
+    auto streaming = GameOfLife_Streaming(gol.Width(), gol.Height());
+    TestUtils::Timer timer;
+    if (!streaming.Advance(inputPath, outputPath, numGenerations))
+        std::cout << "streaming run failed\n";
+    auto elapsed = timer.Elapsed();
+    std::cout << "streaming time, " << inputPath << " to " << outputPath << ": " << elapsed << " milliseconds\n";
+
+    std::ifstream output(outputPath, std::ios::binary);
+    gol.ReadPackedRows(output);
+    return gol.GetState();
 }
-State TwoThreads(GameOfLife& gol)
+
+// Writes the board as RLE and loads it back, the time is that of the round trip.
+State BitPackedRle(GameOfLife_BitPacked& gol, const std::string& path)
 {
     gol.SetInitialState(InitialBoard());
     TestUtils::Timer timer;
-    auto vecThread = std::vector<std::thread>();
-    for (int i = 0; i < 2; i++)
     {
-        vecThread.emplace_back(barrierTwo, std::ref(gol), i);
+        FileWriterStream out(path);
+        WriteRle(out, gol);
     }
-    for (auto& vec: vecThread)
+
+    std::ifstream in(path, std::ios::binary);
+    auto header = RleHeader();
+    if (!ReadRleHeader(in, header))
     {
-        vec.join();
+        std::cout << "invalid rle header in " << path << "\n";
+        return gol.GetState();
     }
+    auto loaded = GameOfLife_BitPacked(header.width, header.height);
+    if (!ReadRleCells(in, loaded))
+        std::cout << "invalid rle cells in " << path << "\n";
+    auto elapsed = timer.Elapsed();
+    std::cout << "rle round trip through " << path << ": " << elapsed << " milliseconds\n";
+    return loaded.GetState();
+}
+
+// Dumps every generation as text, the way PrintBoardState would, into a file.
+State BitPackedFrameDump(GameOfLife_BitPacked& gol, ThreadPool& pool, const std::string& path, WriteBackend backend)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    FileWriterStream out(path, backend);
+    for (int generation = 0; generation < numGenerations; generation++)
+    {
+        gol.WriteBoardState(out);
+        gol.Step(pool);
+    }
+    auto bytes = out.Writer().BytesWritten();
+    auto actualBackend = out.Writer().Backend();
+    auto direct = out.Writer().IsDirect();
+    if (!out.Close())
+        std::cout << "could not write frames to " << path << "\n";
+    auto elapsed = timer.Elapsed();
+    std::cout << "frame dump, " << bytes / (1 << 20) << " MiB through " << WriteBackendName(actualBackend) << (direct ? " with O_DIRECT" : "")
+        << ": " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+// Checkpoints the board after the run and restarts from the checkpoint into a new board.
+State BitPackedCheckpoint(GameOfLife_BitPacked& gol, ThreadPool& pool, const std::string& path)
+{
+    gol.SetInitialState(InitialBoard());
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step(pool);
+
+    TestUtils::Timer timer;
+    {
+        FileWriterStream out(path);
+        if (!WriteCheckpoint(out, gol, numGenerations, pool) || !out.Close())
+            std::cout << "could not write checkpoint " << path << "\n";
+    }
+    auto written = timer.Elapsed();
+
+    std::ifstream in(path, std::ios::binary);
+    auto header = CheckpointHeader();
+    if (!ReadCheckpointHeader(in, header))
+    {
+        std::cout << "invalid checkpoint " << path << "\n";
+        return gol.GetState();
+    }
+    auto restored = GameOfLife_BitPacked(header.width, header.height);
+    if (!ReadCheckpointBoard(in, header, restored, pool))
+        std::cout << "corrupt checkpoint " << path << "\n";
+    auto elapsed = timer.Elapsed();
+    std::cout << "checkpoint of generation " << header.generation << " written in " << written << " milliseconds, restored in " << elapsed - written << " milliseconds\n";
+    return restored.GetState();
+}
+
+State BitPackedBackgroundCheckpoint(GameOfLife_BitPacked& gol, ThreadPool& pool, const std::string& path)
+{
+    // checkpoints halfway, finishes the run, then resumes from the checkpoint so the result can be compared
+    gol.SetInitialState(InitialBoard());
+    auto checkpoint = BackgroundCheckpoint();
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+    {
+        if (generation == numGenerations / 2 && !checkpoint.Start(gol, generation, path))
+            std::cout << "could not start checkpoint " << path << "\n";
+        gol.Step(pool);
+    }
+    auto elapsed = timer.Elapsed();
+    if (!checkpoint.Wait())
+    {
+        std::cout << "could not write checkpoint " << path << "\n";
+        return gol.GetState();
+    }
+    std::cout << "time with background checkpoint: " << elapsed << " milliseconds, fork took " << checkpoint.ForkMicroseconds() << " microseconds\n";
+
+    std::ifstream in(path, std::ios::binary);
+    auto header = CheckpointHeader();
+    auto resumed = GameOfLife_BitPacked(gol.Width(), gol.Height());
+    if (!ReadCheckpointHeader(in, header) || !ReadCheckpointBoard(in, header, resumed, pool))
+    {
+        std::cout << "invalid checkpoint " << path << "\n";
+        return gol.GetState();
+    }
+    for (auto generation = header.generation; generation < static_cast<std::uint64_t>(numGenerations); generation++)
+        resumed.Step(pool);
+    return resumed.GetState();
+}
+
+State BitPackedRule(GameOfLife_BitPacked& gol, const std::string& ruleText)
+{
+    auto rule = ConwayLife;
+    if (!ParseRule(ruleText, rule))
+    {
+        std::cout << "invalid rule " << ruleText << "\n";
+        return gol.GetState();
+    }
+
+    gol.SetInitialState(InitialBoard());
+    gol.SetRule(rule);
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step();
+    auto elapsed = timer.Elapsed();
+    gol.SetRule(ConwayLife);
+    std::cout << "main thread time, bit packed " << RuleToString(rule) << ": " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+// The generic engine with the same boundary is the reference for these.
+State GenericBoundary(GameOfLife& gol, Boundary boundary)
+{
+    gol.SetInitialState(InitialBoard());
+    gol.SetBoundary(boundary);
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.DoStateChanges(gol.GenNextStateChanges());
+    auto elapsed = timer.Elapsed();
+    gol.SetBoundary(Boundary::Dead);
+    std::cout << "main thread time, generic implementation, " << BoundaryName(boundary) << " boundary: " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+State BitPackedBoundary(GameOfLife_BitPacked& gol, Boundary boundary)
+{
+    gol.SetInitialState(InitialBoard());
+    gol.SetBoundary(boundary);
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step();
     auto elapsed = timer.Elapsed();
-    std::cout << "two threads time: " << elapsed << " milliseconds\n";
+    gol.SetBoundary(Boundary::Dead);
+    std::cout << "main thread time, bit packed, " << BoundaryName(boundary) << " boundary: " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
 
+State BitPackedLookupTable(GameOfLife_BitPacked& gol)
+{
+    gol.SetInitialState(InitialBoard());
+    gol.SetUseLookupTable(true);
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step();
+    auto elapsed = timer.Elapsed();
+    gol.SetUseLookupTable(false);
+    std::cout << "main thread time, bit packed lookup table: " << elapsed << " milliseconds\n";
     return gol.GetState();
 }
 
-State MainThreadFourComps(GameOfLife& gol)
+State MainThreadOneRow(GameOfLife& gol)
+{
+    gol.SetInitialState(InitialBoard());
+
+    TestUtils::Timer timer;
+    timer.Reset();
+    auto stateChanges = std::vector<StateChanges>();
+    for (int generation = 0; generation < numGenerations; generation++)
+    {
+        for (int row = 0; row < boardHeight; row++)
+        {
+            stateChanges.push_back(gol.GenNextStateChangesForRow(row));
+        }
+
+        for (const auto& stateChange : stateChanges)
+            gol.DoStateChanges(stateChange);
+
+        stateChanges.clear();
+    }
+    auto elapsed = timer.Elapsed();
+    std::cout << "main thread time, one row at a time: " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+const char* StrategyName(PartitionStrategy strategy)
+{
+    return strategy == PartitionStrategy::RowBands ? "row bands" : "tiles";
+}
+
+State MainThreadComps(GameOfLife& gol, int nrComps)
 {
     gol.SetInitialState(InitialBoard());
+    auto regions = PartitionBoard(boardHeight, boardWidth, nrComps, PartitionStrategy::Tiles, GameOfLife::TileSize);
 
     TestUtils::Timer timer;
     auto stateChanges = std::vector<StateChanges>();
     for (int generation = 0; generation < numGenerations; generation++)
     {
-        for (int compIdx = 0; compIdx < 4; compIdx++)
+        for (const auto& region : regions)
         {
-            stateChanges.push_back(gol.GenNextStateChanges<4>(compIdx));
+            stateChanges.push_back(gol.GenNextStateChanges(region));
         }
 
         for (const auto& stateChange : stateChanges)
@@ -142,110 +444,161 @@ State MainThreadFourComps(GameOfLife& gol)
         stateChanges.clear();
     }
     auto elapsed = timer.Elapsed();
-    std::cout << "main thread time, four comps: " << elapsed << " milliseconds\n";
+    std::cout << "main thread time, " << nrComps << " comps: " << elapsed << " milliseconds\n";
     //gol.PrintBoardState();
     return gol.GetState();
 }
 
-void barrierFour(GameOfLife& gol, int compIdx)
+void barrierRegion(GameOfLife& gol, Region region, SpinBarrier& barrier, int threadIdx)
 {
-    static Barrier bQuart(4);
     for (auto generation = 0; generation < numGenerations; generation++)
     {
-        auto stateChange = gol.GenNextStateChanges<4>(compIdx);
-        bQuart.phase1();
-        stateChangeMutex.wait();
+        auto stateChange = gol.GenNextStateChanges(region);
+        barrier.Wait(threadIdx);
+        // regions are split at TileSize columns, so every worker writes only its own words
         gol.DoStateChanges(stateChange);
-        stateChangeMutex.notify();
-        bQuart.phase2();
+        barrier.Wait(threadIdx);
     }
 }
 
-State FourThreads(GameOfLife& gol)
+State NThreads(GameOfLife& gol, int nrThreads, PartitionStrategy strategy)
 {
     gol.SetInitialState(InitialBoard());
+    auto regions = PartitionBoard(boardHeight, boardWidth, nrThreads, strategy, GameOfLife::TileSize);
+    SpinBarrier barrier(nrThreads);
+
     TestUtils::Timer timer;
     auto vecThread = std::vector<std::thread>();
-    for (int i = 0; i < 4; i++)
+    for (int i = 0; i < nrThreads; i++)
     {
-        vecThread.emplace_back(barrierFour, std::ref(gol), i);
+        vecThread.emplace_back(barrierRegion, std::ref(gol), regions[i], std::ref(barrier), i);
     }
     for (auto& vec: vecThread)
     {
         vec.join();
     }
     auto elapsed = timer.Elapsed();
-    std::cout << "four threads time: " << elapsed << " milliseconds\n";
+    std::cout << nrThreads << " threads time (" << StrategyName(strategy) << "): " << elapsed << " milliseconds\n";
+    barrier.PrintStats(std::cout);
     //gol.PrintBoardState();
 
     return gol.GetState();
 }
 
-void barrierSixteen(GameOfLife& gol, int compIdx)
+// The flat vector<bool> puts the end of one row and the start of the next in the same word,
+// so the contiguous engine still applies its changes one region at a time.
+void barrierRegion_contigous(GameOfLife_Contiguous& gol, Region region, SpinBarrier& barrier, int threadIdx)
 {
-    static Barrier bSixteen(16);
     for (auto generation = 0; generation < numGenerations; generation++)
     {
-        auto stateChange = gol.GenNextStateChanges<16>(compIdx);
-        bSixteen.phase1();
+        auto stateChange = gol.GenNextStateChanges(region);
+        barrier.Wait(threadIdx);
         stateChangeMutex.wait();
         gol.DoStateChanges(stateChange);
         stateChangeMutex.notify();
-        bSixteen.phase2();
+        barrier.Wait(threadIdx);
     }
 }
 
-State SixteenThreads(GameOfLife& gol)
+State_Contiguous NThreads(GameOfLife_Contiguous& gol, int nrThreads, PartitionStrategy strategy)
 {
     gol.SetInitialState(InitialBoard());
+    auto regions = PartitionBoard(boardHeight, boardWidth, nrThreads, strategy);
+    SpinBarrier barrier(nrThreads);
+
     TestUtils::Timer timer;
     auto vecThread = std::vector<std::thread>();
-    for (int i = 0; i < 16; i++)
+    for (int i = 0; i < nrThreads; i++)
     {
-        vecThread.emplace_back(barrierSixteen, std::ref(gol), i);
+        vecThread.emplace_back(barrierRegion_contigous, std::ref(gol), regions[i], std::ref(barrier), i);
     }
     for (auto& vec: vecThread)
     {
         vec.join();
     }
     auto elapsed = timer.Elapsed();
-    std::cout << "sixteen threads time: " << elapsed << " milliseconds\n";
+    std::cout << nrThreads << " threads time, contiguous (" << StrategyName(strategy) << "): " << elapsed << " milliseconds\n";
+    barrier.PrintStats(std::cout);
     //gol.PrintBoardState();
 
     return gol.GetState();
 }
 
-void barrierSixteen_contigous(GameOfLife_Contiguous& gol, int compIdx)
+// Threads are created once with the pool; each generation is a batch of tile tasks, so many
+// more tiles than workers can be used and stealing evens out busy and quiet tiles.
+State PoolTiles(GameOfLife& gol, ThreadPool& pool, int nrTiles)
 {
-    static Barrier bSixteen_contigous(16);
-    for (auto generation = 0; generation < numGenerations; generation++)
+    gol.SetInitialState(InitialBoard());
+    auto regions = PartitionBoard(boardHeight, boardWidth, nrTiles, PartitionStrategy::Tiles, GameOfLife::TileSize);
+
+    TestUtils::Timer timer;
+    auto stateChanges = std::vector<StateChanges>(regions.size());
+    for (int generation = 0; generation < numGenerations; generation++)
     {
-        auto stateChange = gol.GenNextStateChanges<16>(compIdx);
-        bSixteen_contigous.phase1();
-        stateChangeMutex.wait();
-        gol.DoStateChanges(stateChange);
-        stateChangeMutex.notify();
-        bSixteen_contigous.phase2();
+        pool.ParallelFor(static_cast<int>(regions.size()), [&](int tile)
+        {
+            stateChanges[tile] = gol.GenNextStateChanges(regions[tile]);
+        });
+
+        pool.ParallelFor(static_cast<int>(regions.size()), [&](int tile)
+        {
+            gol.DoStateChanges(stateChanges[tile]);
+        });
     }
+    auto elapsed = timer.Elapsed();
+    std::cout << pool.NrThreads() << " pool threads time, " << nrTiles << " tiles: " << elapsed << " milliseconds\n";
+    return gol.GetState();
 }
 
-State_Contiguous SixteenThreads(GameOfLife_Contiguous& gol)
+State PoolOneRow(GameOfLife& gol, ThreadPool& pool)
 {
     gol.SetInitialState(InitialBoard());
+
     TestUtils::Timer timer;
-    auto vecThread = std::vector<std::thread>();
-    for (int i = 0; i < 16; i++)
-    {
-        vecThread.emplace_back(barrierSixteen_contigous, std::ref(gol), i);
-    }
-    for (auto& vec: vecThread)
+    auto stateChanges = std::vector<StateChanges>(boardHeight);
+    for (int generation = 0; generation < numGenerations; generation++)
     {
-        vec.join();
+        pool.ParallelFor(boardHeight, [&](int row)
+        {
+            stateChanges[row] = gol.GenNextStateChangesForRow(row);
+        });
+
+        for (const auto& stateChange : stateChanges)
+            gol.DoStateChanges(stateChange);
     }
     auto elapsed = timer.Elapsed();
-    std::cout << "sixteen threads time: " << elapsed << " milliseconds\n";
-    //gol.PrintBoardState();
+    std::cout << pool.NrThreads() << " pool threads time, one task per row: " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
 
+State BitPackedPool(GameOfLife_BitPacked& gol, ThreadPool& pool)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    for (int generation = 0; generation < numGenerations; generation++)
+        gol.Step(pool);
+    auto elapsed = timer.Elapsed();
+    std::cout << pool.NrThreads() << " pool threads time, bit packed (" << BitKernels::IsaName(gol.GetIsa()) << "): " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+State BitPackedTemporalBlocking(GameOfLife_BitPacked& gol, ThreadPool& pool, int depth)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    gol.Advance(pool, numGenerations, depth);
+    auto elapsed = timer.Elapsed();
+    std::cout << pool.NrThreads() << " pool threads time, bit packed, " << depth << " generations per pass: " << elapsed << " milliseconds\n";
+    return gol.GetState();
+}
+
+State BitPackedDataflow(GameOfLife_BitPacked& gol, ThreadPool& pool, int maxSkew)
+{
+    gol.SetInitialState(InitialBoard());
+    TestUtils::Timer timer;
+    gol.AdvanceDataflow(pool, numGenerations, maxSkew);
+    auto elapsed = timer.Elapsed();
+    std::cout << pool.NrThreads() << " pool threads time, bit packed dataflow, max skew " << maxSkew << ": " << elapsed << " milliseconds\n";
     return gol.GetState();
 }
 
@@ -256,7 +609,7 @@ State OneThreadOneRow(GameOfLife& gol)
 
     TestUtils::Timer timer;
     timer.Reset();
-    for (int i = 0; i < boardSize; i++)
+    for (int i = 0; i < boardHeight; i++)
     {
         vecThread.emplace_back(barrierRow, std::ref(gol), i);
     }
@@ -271,46 +624,141 @@ State OneThreadOneRow(GameOfLife& gol)
 
 //int main()
 //{
-//    auto gol = GameOfLife(boardSize);
+//    auto gol = GameOfLife(boardWidth, boardHeight);
 //    //gol.SetInitialState(InitialBoard());
 //    //gol.PrintBoardState();
-//    std::cout << boardSize << " x " << boardSize << " grid\n";
+//    std::cout << boardWidth << " x " << boardHeight << " grid\n";
 //
 //    auto genericImplementationState = GenericImplementation(gol);
 //    //auto oneRowState = MainThreadOneRow(gol);
 //
-//    auto twoThreadState = TwoThreads(gol);
+//    auto twoThreadState = NThreads(gol, 2, PartitionStrategy::RowBands);
 //    if (twoThreadState == genericImplementationState)
 //        std::cout << "states are equal\n";
 //    else
 //        std::cout << "states are not equal\n";
 //
-//    //auto fourComps = MainThreadFourComps(gol);
+//    //auto fourComps = MainThreadComps(gol, 4);
 //    //if (fourComps == genericImplementationState)
 //    //    std::cout << "states are equal\n";
 //    //else
 //    //    std::cout << "states are not equal\n";
 //
-//    auto fourThreadState = FourThreads(gol);
+//    auto fourThreadState = NThreads(gol, 4, PartitionStrategy::Tiles);
 //    if (fourThreadState == genericImplementationState)
 //        std::cout << "states are equal\n";
 //    else
 //        std::cout << "states are not equal\n";
 //
-//    auto sixteenThreadState = SixteenThreads(gol);
+//    auto sixteenThreadState = NThreads(gol, 16, PartitionStrategy::Tiles);
 //    if (sixteenThreadState == genericImplementationState)
 //        std::cout << "states are equal\n";
 //    else
 //        std::cout << "states are not equal\n";
 //
-//    auto gol_contigous = GameOfLife_Contiguous(boardSize);
+//    auto allCoresState = NThreads(gol, std::max(1u, std::thread::hardware_concurrency()), PartitionStrategy::Tiles);
+//    if (allCoresState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
 //
-//    auto sixteenThreadState_contigous = SixteenThreads(gol_contigous);
+//    auto pool = ThreadPool();
+//    auto poolState = PoolTiles(gol, pool, 4 * pool.NrThreads());
+//    if (poolState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto gol_contigous = GameOfLife_Contiguous(boardWidth, boardHeight);
+//
+//    auto sixteenThreadState_contigous = NThreads(gol_contigous, 16, PartitionStrategy::Tiles);
 //    //if (sixteenThreadState_contigous == genericImplementationState)
 //    //    std::cout << "states are equal\n";
 //    //else
 //    //    std::cout << "states are not equal\n";
 //
+//    auto gol_bitPacked = GameOfLife_BitPacked(boardWidth, boardHeight);
+//    auto bitPackedState = BitPackedImplementation(gol_bitPacked);
+//    if (bitPackedState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto bitPackedDoubleBufferedState = BitPackedDoubleBuffered(gol_bitPacked);
+//    if (bitPackedDoubleBufferedState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto bitPackedPoolState = BitPackedPool(gol_bitPacked, pool);
+//    if (bitPackedPoolState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto temporalBlockingState = BitPackedTemporalBlocking(gol_bitPacked, pool, 8);
+//    if (temporalBlockingState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto dataflowState = BitPackedDataflow(gol_bitPacked, pool, 4);
+//    if (dataflowState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto gol_mapped = GameOfLife_BitPacked(boardWidth, boardHeight);
+//    auto mappedState = BitPackedMapped(gol_mapped, "board.gol");
+//    if (mappedState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto streamingState = StreamingImplementation(gol_bitPacked, "generation-in.bin", "generation-out.bin");
+//    if (streamingState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto rleState = BitPackedRle(gol_bitPacked, "board.rle");
+//    if (rleState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto frameDumpState = BitPackedFrameDump(gol_bitPacked, pool, "frames.txt", WriteBackend::IoUring);
+//    if (frameDumpState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto checkpointState = BitPackedCheckpoint(gol_bitPacked, pool, "board.ckpt");
+//    if (checkpointState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto backgroundCheckpointState = BitPackedBackgroundCheckpoint(gol_bitPacked, pool, "background.ckpt");
+//    if (backgroundCheckpointState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto gol_distributed = GameOfLife_Distributed(boardWidth, boardHeight, 4, HaloTransport::SharedMemory);
+//    auto distributedState = DistributedImplementation(gol_distributed);
+//    if (distributedState == genericImplementationState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
+//    auto genericTorusState = GenericBoundary(gol, Boundary::Torus);
+//    auto bitPackedTorusState = BitPackedBoundary(gol_bitPacked, Boundary::Torus);
+//    if (bitPackedTorusState == genericTorusState)
+//        std::cout << "states are equal\n";
+//    else
+//        std::cout << "states are not equal\n";
+//
 //    //auto rowThreadState = OneThreadOneRow(gol);
 //    //if (rowThreadState == genericImplementationState)
 //    //    std::cout << "states are equal\n";
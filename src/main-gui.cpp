@@ -11,7 +11,9 @@
 #include <SDL.h>
 
 #include <ImplGameOfLife.h>
+#include <Partitioning.h>
 #include <ThreadUtils.h>
+#include <algorithm>
 #include <thread>
 #include <vector>
 
@@ -29,47 +31,45 @@
 //static int n = 2;
 
 static Semaphore simSemaphore(0);
-static Barrier bSixteen(16);
-static Semaphore sixteenSemaphore(0);
+static Semaphore workerSemaphore(0);
 static Semaphore mutex(1);
 
 namespace {
-    void barrierSixteen(GameOfLife& gol, int compIdx, bool& done)
+    void barrierRegion(GameOfLife& gol, Region region, SpinBarrier& barrier, int threadIdx, bool& done)
     {
-        static Semaphore stateChangeMutex(1);
-        sixteenSemaphore.wait(); // wait for the simulation thread to notify the start
+        workerSemaphore.wait(); // wait for the simulation thread to notify the start
        
         while (!done)
         {
-            auto stateChange = gol.GenNextStateChanges<16>(compIdx);
-            bSixteen.phase1();
-            stateChangeMutex.wait();
+            auto stateChange = gol.GenNextStateChanges(region);
+            barrier.Wait(threadIdx);
             gol.DoStateChanges(stateChange);
-            stateChangeMutex.notify();
-            bSixteen.phase2();
+            barrier.Wait(threadIdx);
 
-            sixteenSemaphore.wait();
+            workerSemaphore.wait();
         }
     }
 
     void SimulationThreadCode(GameOfLife& gol, bool& done)
     {
+        auto nrWorkers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        auto regions = PartitionBoard(gol.Height(), gol.Width(), nrWorkers, PartitionStrategy::Tiles, GameOfLife::TileSize);
+        SpinBarrier barrier(nrWorkers);
+
         auto vecThread = std::vector<std::thread>();
-        for (int i = 0; i < 16; i++)
+        for (int i = 0; i < nrWorkers; i++)
         {
-            vecThread.emplace_back(barrierSixteen, std::ref(gol), i, std::ref(done));
+            vecThread.emplace_back(barrierRegion, std::ref(gol), regions[i], std::ref(barrier), i, std::ref(done));
         }
         do
         {
             simSemaphore.wait();
 
-            // notify the 16 threads to start
-            for (auto i = 0; i < 16; i++)
-                sixteenSemaphore.notify();
+            // notify the workers to start
+            workerSemaphore.notify(nrWorkers);
         } while (!done);
 
-        for (int i = 0; i < 16; i++)
-            sixteenSemaphore.notify();
+        workerSemaphore.notify(nrWorkers);
         for (auto& vec : vecThread)
         {
             vec.join();
@@ -142,8 +142,9 @@ int main(int, char**)
     auto rectSize = ImVec2{ 5., 5. };
 
 
-    auto boardSize = 200;
-    auto gol = GameOfLife(boardSize);
+    auto boardWidth = 200;
+    auto boardHeight = 200;
+    auto gol = GameOfLife(boardWidth, boardHeight);
     gol.InitBoardWithRandomData(5);
     //gol.SetInitialState({
     //    {1, 1},
@@ -263,15 +264,15 @@ int main(int, char**)
                 }
             }
             ImGui::Text("semaphore count %d", simSemaphore.GetCount());
-            ImGui::Text("Sixteen count %d", sixteenSemaphore.GetCount());
+            ImGui::Text("Worker count %d", workerSemaphore.GetCount());
 
             ImGui::NewLine();
             ImVec2 startPosition = ImGui::GetCursorScreenPos();      // this is the position at which the next ImGui object will be drawn, ImDrawList API uses screen coordinates!
 
             ImDrawList* drawList = ImGui::GetWindowDrawList();
             auto colorToDraw = green;
-            for (int y = 0; y < boardSize; y++)
-                for (int x = 0; x < boardSize; x++)
+            for (int y = 0; y < boardWidth; y++)
+                for (int x = 0; x < boardHeight; x++)
                 {
                     auto rectStart = ImVec2(startPosition.x + x * rectSize.x, startPosition.y + y * rectSize.y);
                     colorToDraw = green;
@@ -0,0 +1,155 @@
+#include <doctest/doctest.h>
+
+#include <random>
+#include <utility>
+#include <vector>
+#include <BitKernels.h>
+#include <ImplGameOfLife_BitPacked.h>
+#include "TestFiles.h"
+
+// The vector kernels only run where the CPU picks them, so every ISA this CPU supports is checked
+// against the scalar code here, whatever DetectIsa would choose.
+namespace
+{
+    constexpr int NrWords = 40;
+    constexpr Word Untouched = 0xDEADBEEFDEADBEEFull;
+
+    std::vector<BitKernels::Isa> AvailableIsas()
+    {
+        auto isas = std::vector<BitKernels::Isa>();
+        for (auto isa : { BitKernels::Isa::Scalar, BitKernels::Isa::AVX2, BitKernels::Isa::AVX512 })
+        {
+            if (isa <= BitKernels::DetectIsa())
+                isas.push_back(isa);
+        }
+        return isas;
+    }
+
+    // NrWords words with a ghost word on each side; row() points past the first ghost.
+    struct Row
+    {
+        std::vector<Word> words = std::vector<Word>(NrWords + 2);
+
+        Word* operator()()
+        {
+            return words.data() + 1;
+        }
+    };
+
+    Row RandomRow(std::mt19937_64& random)
+    {
+        auto row = Row();
+        for (auto& word : row.words)
+            word = random() & random();
+        return row;
+    }
+
+    Row UntouchedRow()
+    {
+        auto row = Row();
+        row.words.assign(NrWords + 2, Untouched);
+        return row;
+    }
+
+    // Word ranges of all lengths around the vector widths, at aligned and unaligned starts.
+    const std::pair<int, int> Ranges[] = { { 0, NrWords }, { 1, NrWords - 1 }, { 0, 1 }, { 3, 4 }, { 0, 4 }, { 0, 8 }, { 1, 9 }, { 2, 19 }, { 5, 37 }, { 7, 23 } };
+}
+
+TEST_CASE("row kernels of every available ISA match the scalar kernel")
+{
+    auto random = std::mt19937_64(21);
+    // the last one has no specialized kernels
+    auto rules = std::vector<Rule>(BuiltinRules.begin(), BuiltinRules.end());
+    rules.emplace_back();
+    REQUIRE(ParseRule("B36/S125", rules.back()));
+
+    for (auto isa : AvailableIsas())
+    {
+        CAPTURE(BitKernels::IsaName(isa));
+        for (const auto& rule : rules)
+        {
+            CAPTURE(RuleToString(rule));
+            auto kernel = BitKernels::SelectRowKernel(isa, rule);
+            for (int trial = 0; trial < 20; trial++)
+            {
+                auto above = RandomRow(random);
+                auto row = RandomRow(random);
+                auto below = RandomRow(random);
+                for (auto [firstWord, lastWord] : Ranges)
+                {
+                    CAPTURE(firstWord);
+                    CAPTURE(lastWord);
+                    auto expected = UntouchedRow();
+                    auto next = UntouchedRow();
+                    BitKernels::StepRowAnyRule(above(), row(), below(), expected(), firstWord, lastWord, rule);
+                    kernel(above(), row(), below(), next(), firstWord, lastWord, rule);
+                    // also nothing written outside the range
+                    CHECK(next.words == expected.words);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("lookup table kernel matches the scalar kernel")
+{
+    auto random = std::mt19937_64(22);
+    for (const auto& rule : BuiltinRules)
+    {
+        CAPTURE(RuleToString(rule));
+        const auto* table = BitKernels::LookupTable(rule);
+        for (int trial = 0; trial < 20; trial++)
+        {
+            auto above = RandomRow(random);
+            auto row = RandomRow(random);
+            auto rowBelow = RandomRow(random);
+            auto below = RandomRow(random);
+            for (auto [firstWord, lastWord] : Ranges)
+            {
+                CAPTURE(firstWord);
+                CAPTURE(lastWord);
+                auto expected = UntouchedRow();
+                auto expectedBelow = UntouchedRow();
+                auto next = UntouchedRow();
+                auto nextBelow = UntouchedRow();
+                BitKernels::StepRowAnyRule(above(), row(), rowBelow(), expected(), firstWord, lastWord, rule);
+                BitKernels::StepRowAnyRule(row(), rowBelow(), below(), expectedBelow(), firstWord, lastWord, rule);
+                BitKernels::StepRowPairLookup(above(), row(), rowBelow(), below(), next(), nextBelow(), firstWord, lastWord, table);
+                CHECK(next.words == expected.words);
+                CHECK(nextBelow.words == expectedBelow.words);
+            }
+        }
+    }
+}
+
+TEST_CASE("bit-packed boards step alike on every available ISA")
+{
+    for (auto [width, height] : { std::pair<int, int>{ 1000, 50 }, { 64 * 9 + 1, 31 }, { 255, 64 } })
+    {
+        CAPTURE(width);
+        auto reference = GameOfLife_BitPacked(width, height);
+        reference.SetIsa(BitKernels::Isa::Scalar);
+        reference.SetBoundary(Boundary::Torus);
+        reference.SetInitialState(RandomState(width, height, 23));
+        for (int generation = 0; generation < 8; generation++)
+            reference.Step();
+
+        for (auto isa : AvailableIsas())
+        {
+            for (auto useLookupTable : { false, true })
+            {
+                CAPTURE(BitKernels::IsaName(isa));
+                CAPTURE(useLookupTable);
+                auto gol = GameOfLife_BitPacked(width, height);
+                gol.SetIsa(isa);
+                CHECK(gol.GetIsa() == isa);
+                gol.SetUseLookupTable(useLookupTable);
+                gol.SetBoundary(Boundary::Torus);
+                gol.SetInitialState(RandomState(width, height, 23));
+                for (int generation = 0; generation < 8; generation++)
+                    gol.Step();
+                CHECK(gol.GetState() == reference.GetState());
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#include <doctest/doctest.h>
+
+#include <climits>
+#include <ImplGameOfLife_BitPacked.h>
+#include "TestFiles.h"
+
+namespace
+{
+    // offsets of the header fields after the 8-byte magic, version and header size
+    constexpr std::streamoff WidthOffset = 16;
+    constexpr std::streamoff HeightOffset = 20;
+    constexpr std::streamoff RowStrideOffset = 24;
+
+    void WriteBoardFile(const std::string& path, int width, int height)
+    {
+        auto gol = GameOfLife_BitPacked(width, height);
+        gol.SetInitialState(RandomState(width, height, 1));
+        REQUIRE(gol.MapToFile(path));
+        gol.Step();
+        REQUIRE(gol.SyncMappedFile());
+    }
+}
+
+TEST_CASE("board file reopens at the generation it was left at")
+{
+    auto file = TempFile("reopen.gol");
+    auto gol = GameOfLife_BitPacked(150, 70);
+    gol.SetInitialState(RandomState(150, 70, 2));
+    gol.SetBoundary(Boundary::Torus);
+    REQUIRE(gol.MapToFile(file.Path()));
+    for (int generation = 0; generation < 5; generation++)
+        gol.Step();
+    REQUIRE(gol.SyncMappedFile());
+
+    auto info = GameOfLife_BitPacked::BoardFileInfo();
+    REQUIRE(GameOfLife_BitPacked::ReadBoardFileInfo(file.Path(), info));
+    CHECK(info.width == 150);
+    CHECK(info.height == 70);
+    CHECK(info.boundary == Boundary::Torus);
+
+    auto reopened = GameOfLife_BitPacked(info.width, info.height);
+    REQUIRE(reopened.OpenMappedFile(file.Path()));
+    CHECK(reopened.GetState() == gol.GetState());
+    CHECK(reopened.GetBoundary() == Boundary::Torus);
+}
+
+TEST_CASE("board file info is read from a read-only file")
+{
+    auto file = TempFile("readonly.gol");
+    WriteBoardFile(file.Path(), 100, 10);
+    std::filesystem::permissions(file.Path(), std::filesystem::perms::owner_read);
+
+    auto info = GameOfLife_BitPacked::BoardFileInfo();
+    CHECK(GameOfLife_BitPacked::ReadBoardFileInfo(file.Path(), info));
+    CHECK(info.width == 100);
+    std::filesystem::permissions(file.Path(), std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+}
+
+TEST_CASE("board file headers that do not match the layout are rejected")
+{
+    auto file = TempFile("corrupt.gol");
+    auto info = GameOfLife_BitPacked::BoardFileInfo();
+
+    WriteBoardFile(file.Path(), 100, 10);
+    PatchFile<std::int32_t>(file.Path(), RowStrideOffset, 5);
+    CHECK_FALSE(GameOfLife_BitPacked::ReadBoardFileInfo(file.Path(), info));
+
+    // a wider board with the same stride would read past its rows
+    WriteBoardFile(file.Path(), 100, 10);
+    PatchFile<std::int32_t>(file.Path(), WidthOffset, 200);
+    CHECK_FALSE(GameOfLife_BitPacked::ReadBoardFileInfo(file.Path(), info));
+
+    WriteBoardFile(file.Path(), 100, 10);
+    PatchFile<std::int32_t>(file.Path(), HeightOffset, INT_MAX);
+    CHECK_FALSE(GameOfLife_BitPacked::ReadBoardFileInfo(file.Path(), info));
+
+    WriteBoardFile(file.Path(), 100, 10);
+    PatchFile<char>(file.Path(), 0, 'X');
+    CHECK_FALSE(GameOfLife_BitPacked::ReadBoardFileInfo(file.Path(), info));
+
+    WriteBoardFile(file.Path(), 100, 10);
+    std::filesystem::resize_file(file.Path(), 4096 + 8);
+    CHECK_FALSE(GameOfLife_BitPacked::ReadBoardFileInfo(file.Path(), info));
+    auto gol = GameOfLife_BitPacked(100, 10);
+    CHECK_FALSE(gol.OpenMappedFile(file.Path()));
+}
+
+TEST_CASE("missing board files are rejected")
+{
+    auto info = GameOfLife_BitPacked::BoardFileInfo();
+    CHECK_FALSE(GameOfLife_BitPacked::ReadBoardFileInfo("/nonexistent/board.gol", info));
+}
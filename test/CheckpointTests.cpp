@@ -0,0 +1,253 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <Checkpoint.h>
+#include <Compression.h>
+#include "TestFiles.h"
+
+namespace
+{
+    // offsets in the 48-byte file header, the band table follows it
+    constexpr std::size_t GenerationOffset = 32;
+    constexpr std::size_t BandRowsOffset = 40;
+    constexpr std::size_t BandTableOffset = 48;
+
+    std::string Checkpoint(const GameOfLife_BitPacked& gol, std::uint64_t generation)
+    {
+        std::ostringstream out;
+        REQUIRE(WriteCheckpoint(out, gol, generation));
+        return out.str();
+    }
+
+    template <typename T>
+    void Patch(std::string& data, std::size_t offset, T value)
+    {
+        std::memcpy(&data[offset], &value, sizeof(value));
+    }
+
+    bool Restore(const std::string& data, GameOfLife_BitPacked& gol)
+    {
+        std::istringstream in(data);
+        auto header = CheckpointHeader();
+        return ReadCheckpointHeader(in, header) && ReadCheckpointBoard(in, header, gol);
+    }
+}
+
+TEST_CASE("word codec round trips sparse, dense and empty input")
+{
+    std::mt19937_64 random(6);
+    for (std::size_t nrWords : { 0, 1, 7, 1000, 70000 })
+    {
+        for (int density : { 0, 1, 50, 100 })
+        {
+            auto words = std::vector<Word>(nrWords);
+            for (auto& word : words)
+                word = static_cast<int>(random() % 100) < density ? random() : 0;
+
+            auto encoded = Compression::EncodeWords(words.data(), words.size());
+            auto decoded = std::vector<Word>(nrWords, ~Word(0));
+            REQUIRE(Compression::DecodeWords(encoded.data(), encoded.size(), decoded.data(), decoded.size()));
+            CHECK(decoded == words);
+        }
+    }
+}
+
+TEST_CASE("word codec rejects corrupt and truncated data")
+{
+    std::mt19937_64 random(7);
+    auto words = std::vector<Word>(5000);
+    for (std::size_t i = 0; i < words.size(); i += 3)
+        words[i] = random();
+    auto encoded = Compression::EncodeWords(words.data(), words.size());
+    auto decoded = std::vector<Word>(words.size());
+
+    CHECK_FALSE(Compression::DecodeWords(encoded.data(), encoded.size() / 2, decoded.data(), decoded.size()));
+    CHECK_FALSE(Compression::DecodeWords(encoded.data(), encoded.size(), decoded.data(), decoded.size() - 1));
+    // random garbage must fail cleanly or decode to something, never overrun
+    for (int attempt = 0; attempt < 200; attempt++)
+    {
+        auto corrupt = encoded;
+        corrupt[random() % corrupt.size()] ^= static_cast<std::uint8_t>(1 + random() % 255);
+        Compression::DecodeWords(corrupt.data(), corrupt.size(), decoded.data(), decoded.size());
+    }
+}
+
+TEST_CASE("checkpoint restores board, rule, boundary and generation")
+{
+    auto gol = GameOfLife_BitPacked(300, 600);
+    gol.SetInitialState(RandomState(300, 600, 8));
+    gol.SetRule(DayAndNight);
+    gol.SetBoundary(Boundary::Torus);
+    auto pool = ThreadPool(4);
+    std::ostringstream out;
+    REQUIRE(WriteCheckpoint(out, gol, 1234, pool));
+    CHECK(out.str() == Checkpoint(gol, 1234));
+
+    std::istringstream in(out.str());
+    auto header = CheckpointHeader();
+    REQUIRE(ReadCheckpointHeader(in, header));
+    CHECK(header.width == 300);
+    CHECK(header.height == 600);
+    CHECK(header.generation == 1234);
+    auto restored = GameOfLife_BitPacked(header.width, header.height);
+    REQUIRE(ReadCheckpointBoard(in, header, restored, pool));
+    CHECK(restored.GetState() == gol.GetState());
+    CHECK(restored.GetRule() == DayAndNight);
+    CHECK(restored.GetBoundary() == Boundary::Torus);
+}
+
+TEST_CASE("checkpoint of an empty board restores")
+{
+    auto gol = GameOfLife_BitPacked(64, 3);
+    auto restored = GameOfLife_BitPacked(64, 3);
+    restored.SetCell(1, 1, true);
+    REQUIRE(Restore(Checkpoint(gol, 0), restored));
+    CHECK(restored.Population() == 0);
+}
+
+TEST_CASE("checkpoint rejects corrupt and crafted files")
+{
+    auto gol = GameOfLife_BitPacked(100, 300);
+    gol.SetInitialState(RandomState(100, 300, 9));
+    auto data = Checkpoint(gol, 5);
+    auto restored = GameOfLife_BitPacked(100, 300);
+
+    auto flipped = data;
+    flipped[data.size() - 10] ^= 0x55;
+    CHECK_FALSE(Restore(flipped, restored));
+
+    CHECK_FALSE(Restore(data.substr(0, data.size() - 1), restored));
+    CHECK_FALSE(Restore(data.substr(0, 20), restored));
+
+    auto otherSize = GameOfLife_BitPacked(100, 299);
+    CHECK_FALSE(Restore(data, otherSize));
+
+    auto hugeBands = data;
+    Patch<std::int32_t>(hugeBands, BandRowsOffset, INT_MAX);
+    Patch<std::uint32_t>(hugeBands, BandRowsOffset + 4, 1);
+    CHECK_FALSE(Restore(hugeBands, restored));
+
+    // the second band has 44 rows, a size that would fit 256 rows is still too large
+    auto oversized = data;
+    Patch<std::uint64_t>(oversized, BandTableOffset + 16, 2 * 256 * 2 * sizeof(Word));
+    CHECK_FALSE(Restore(oversized, restored));
+
+    auto wrongMagic = data;
+    wrongMagic[0] = 'X';
+    CHECK_FALSE(Restore(wrongMagic, restored));
+
+    auto generation = data;
+    Patch<std::uint64_t>(generation, GenerationOffset, 77);
+    std::istringstream in(generation);
+    auto header = CheckpointHeader();
+    REQUIRE(ReadCheckpointHeader(in, header));
+    CHECK(header.generation == 77);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <sys/time.h>
+
+namespace
+{
+    void IgnoreAlarm(int)
+    {
+    }
+}
+#endif
+
+TEST_CASE("background checkpoint writes the generation it was started at")
+{
+    if (!BackgroundCheckpoint::IsSupported())
+        return;
+
+    auto file = TempFile("background.ckpt");
+    auto gol = GameOfLife_BitPacked(1000, 1000);
+    gol.SetInitialState(RandomState(1000, 1000, 11));
+    auto atStart = gol.GetState();
+
+    auto checkpoint = BackgroundCheckpoint();
+    REQUIRE(checkpoint.Start(gol, 42, file.Path()));
+    if (checkpoint.IsRunning())
+        CHECK_FALSE(checkpoint.Start(gol, 43, file.Path()));
+    // the parent goes on while the child writes
+    for (int generation = 0; generation < 3; generation++)
+        gol.Step();
+    REQUIRE(checkpoint.Wait());
+    CHECK_FALSE(checkpoint.Wait());
+
+    auto restored = GameOfLife_BitPacked(1000, 1000);
+    REQUIRE(Restore(ReadWholeFile(file.Path()), restored));
+    CHECK(restored.GetState() == atStart);
+}
+
+TEST_CASE("background checkpoint reports failures and refuses mapped boards")
+{
+    if (!BackgroundCheckpoint::IsSupported())
+        return;
+
+    auto gol = GameOfLife_BitPacked(64, 64);
+    auto checkpoint = BackgroundCheckpoint();
+    REQUIRE(checkpoint.Start(gol, 0, "/nonexistent/board.ckpt"));
+    CHECK_FALSE(checkpoint.Wait());
+
+    auto file = TempFile("mapped.gol");
+    REQUIRE(gol.MapToFile(file.Path()));
+    CHECK_FALSE(checkpoint.Start(gol, 0, file.Path() + ".ckpt"));
+}
+
+TEST_CASE("background checkpoint keeps a failure that was not waited for")
+{
+    if (!BackgroundCheckpoint::IsSupported())
+        return;
+
+    auto file = TempFile("after-failure.ckpt");
+    auto gol = GameOfLife_BitPacked(64, 64);
+    auto checkpoint = BackgroundCheckpoint();
+    REQUIRE(checkpoint.Start(gol, 0, "/nonexistent/board.ckpt"));
+    // IsRunning collects the failed child before the next Start
+    while (checkpoint.IsRunning())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    REQUIRE(checkpoint.Start(gol, 1, file.Path()));
+    CHECK_FALSE(checkpoint.Wait());
+    CHECK(std::filesystem::exists(file.Path()));
+
+    REQUIRE(checkpoint.Start(gol, 2, file.Path()));
+    CHECK(checkpoint.Wait());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("background checkpoint wait is not cut short by signals")
+{
+    auto file = TempFile("signals.ckpt");
+    auto gol = GameOfLife_BitPacked(2000, 2000);
+    gol.SetInitialState(RandomState(2000, 2000, 12));
+
+    // without SA_RESTART every alarm interrupts waitpid
+    struct sigaction action = {};
+    struct sigaction previous = {};
+    action.sa_handler = IgnoreAlarm;
+    sigemptyset(&action.sa_mask);
+    ::sigaction(SIGALRM, &action, &previous);
+    auto timer = itimerval{ { 0, 1000 }, { 0, 1000 } };
+    ::setitimer(ITIMER_REAL, &timer, nullptr);
+
+    auto checkpoint = BackgroundCheckpoint();
+    auto started = checkpoint.Start(gol, 1, file.Path());
+    auto written = started && checkpoint.Wait();
+
+    timer = itimerval{};
+    ::setitimer(ITIMER_REAL, &timer, nullptr);
+    ::sigaction(SIGALRM, &previous, nullptr);
+
+    REQUIRE(started);
+    CHECK(written);
+    auto restored = GameOfLife_BitPacked(2000, 2000);
+    REQUIRE(Restore(ReadWholeFile(file.Path()), restored));
+    CHECK(restored.GetState() == gol.GetState());
+}
+#endif
@@ -0,0 +1,166 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <HaloTransport.h>
+#include <ImplGameOfLife_BitPacked.h>
+#include <ImplGameOfLife_Distributed.h>
+#include "TestFiles.h"
+
+namespace
+{
+    const HaloTransport Transports[] = { HaloTransport::UnixSocket, HaloTransport::SharedMemory };
+
+    std::vector<char> Pattern(std::size_t size)
+    {
+        auto bytes = std::vector<char>(size);
+        for (std::size_t i = 0; i < size; i++)
+            bytes[i] = static_cast<char>(i * 7 + i / 251);
+        return bytes;
+    }
+
+    // Children of this process, from /proc.
+    std::vector<pid_t> ChildProcesses()
+    {
+        auto children = std::vector<pid_t>();
+        auto* proc = ::opendir("/proc");
+        if (!proc)
+            return children;
+        while (auto* entry = ::readdir(proc))
+        {
+            auto pid = std::atoi(entry->d_name);
+            if (pid <= 0)
+                continue;
+            // the parent is the second field after the name, which is in parentheses
+            auto stat = ReadWholeFile("/proc/" + std::string(entry->d_name) + "/stat");
+            auto nameEnd = stat.rfind(')');
+            if (nameEnd == std::string::npos)
+                continue;
+            char state = 0;
+            int parent = 0;
+            if (std::sscanf(stat.c_str() + nameEnd + 1, " %c %d", &state, &parent) == 2 && parent == ::getpid())
+                children.push_back(pid);
+        }
+        ::closedir(proc);
+        return children;
+    }
+}
+
+TEST_CASE("halo links are byte streams")
+{
+    for (auto transport : Transports)
+    {
+        CAPTURE(HaloTransportName(transport));
+        auto [first, second] = CreateLinkPair(transport);
+        REQUIRE(first);
+
+        // a sender thread, as a piece larger than the link's buffer blocks until it is read
+        const auto sent = Pattern(300000);
+        auto sender = std::thread([&, &first = first]
+        {
+            CHECK(first->Send(sent.data(), 100));
+            CHECK(first->Send(sent.data() + 100, sent.size() - 100));
+        });
+
+        // smaller and larger than what each Send wrote, and across the link's pieces
+        auto received = std::vector<char>(sent.size());
+        std::size_t offset = 0;
+        for (std::size_t size : { 1, 30, 69, 1000, 70000, 65536, 3 })
+        {
+            REQUIRE(second->Receive(received.data() + offset, size));
+            offset += size;
+        }
+        REQUIRE(second->Receive(received.data() + offset, sent.size() - offset));
+        sender.join();
+        CHECK(received == sent);
+    }
+}
+
+TEST_CASE("halo link fails once the other process is gone")
+{
+    for (auto transport : Transports)
+    {
+        CAPTURE(HaloTransportName(transport));
+        auto [first, second] = CreateLinkPair(transport);
+        REQUIRE(first);
+
+        auto pid = ::fork();
+        REQUIRE(pid >= 0);
+        if (pid == 0)
+        {
+            second->Close();
+            auto message = Pattern(10);
+            ::_exit(first->Send(message.data(), message.size()) ? 0 : 1);
+        }
+        first->Close();
+
+        // what was sent before the exit still arrives
+        auto received = std::vector<char>(10);
+        CHECK(second->Receive(received.data(), received.size()));
+        CHECK(received == Pattern(10));
+        CHECK_FALSE(second->Receive(received.data(), 1));
+
+        const auto large = Pattern(200000);
+        CHECK_FALSE(second->Send(large.data(), large.size()));
+        ::waitpid(pid, nullptr, 0);
+    }
+}
+
+TEST_CASE("distributed advance matches the bit-packed engine")
+{
+    for (auto transport : Transports)
+    {
+        CAPTURE(HaloTransportName(transport));
+        auto gol = GameOfLife_BitPacked(200, 90);
+        gol.SetInitialState(RandomState(200, 90, 31));
+        auto distributed = GameOfLife_Distributed(200, 90, 3, transport);
+        distributed.SetInitialState(RandomState(200, 90, 31));
+
+        REQUIRE(distributed.Advance(7, 3));
+        for (int generation = 0; generation < 7; generation++)
+            gol.Step();
+        CHECK(distributed.GetState() == gol.GetState());
+        REQUIRE(distributed.Stats().size() == 3);
+        CHECK(distributed.Stats().back().generation == 7);
+        CHECK(distributed.Stats().back().population == gol.Population());
+    }
+}
+
+TEST_CASE("distributed advance fails when a worker is killed")
+{
+    for (auto transport : Transports)
+    {
+        CAPTURE(HaloTransportName(transport));
+        auto distributed = GameOfLife_Distributed(100, 60, 3, transport);
+        distributed.SetInitialState(RandomState(100, 60, 32));
+        const auto before = distributed.GetState();
+
+        auto killer = std::thread([]
+        {
+            for (;;)
+            {
+                auto children = ChildProcesses();
+                if (children.size() == 3)
+                {
+                    ::kill(children[1], SIGKILL);
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        });
+        CHECK_FALSE(distributed.Advance(1 << 30, 0));
+        killer.join();
+        CHECK(distributed.GetState() == before);
+        CHECK(distributed.Generation() == 0);
+        CHECK(ChildProcesses().empty());
+    }
+}
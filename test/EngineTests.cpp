@@ -0,0 +1,355 @@
+#include <doctest/doctest.h>
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <Boundary.h>
+#include <ImplGameOfLife.h>
+#include <ImplGameOfLife_BitPacked.h>
+#include <ImplGameOfLife_Contiguous.h>
+#include <ImplGameOfLife_Distributed.h>
+#include <ImplGameOfLife_HashLife.h>
+#include <ImplGameOfLife_Sparse.h>
+#include <ImplGameOfLife_Streaming.h>
+#include <ThreadPool.h>
+#include "TestFiles.h"
+
+// Every engine against a brute-force stepper that reads the neighbours through WrapCoordinate,
+// on boards whose widths sit around multiples of 64 and on single row and column strips.
+namespace
+{
+    constexpr int Generations = 6;
+
+    struct Size
+    {
+        int width;
+        int height;
+    };
+
+    const Size Sizes[] = { { 63, 17 }, { 64, 20 }, { 65, 9 }, { 127, 33 }, { 128, 16 }, { 129, 40 }, { 1, 30 }, { 30, 1 }, { 1, 1 }, { 200, 70 } };
+
+    std::vector<Rule> Rules()
+    {
+        auto rules = std::vector<Rule>(BuiltinRules.begin(), BuiltinRules.end());
+        // no specialized kernel for this one
+        auto rule = Rule();
+        REQUIRE(ParseRule("B36/S125", rule));
+        rules.push_back(rule);
+        return rules;
+    }
+
+    State ReferenceStep(const State& state, const Rule& rule, Boundary boundary)
+    {
+        auto height = static_cast<int>(state.size());
+        auto width = static_cast<int>(state.front().size());
+        auto next = state;
+        for (int i = 0; i < height; i++)
+        {
+            for (int j = 0; j < width; j++)
+            {
+                auto nrAliveNeighbors = 0;
+                for (int offX = -1; offX <= 1; offX++)
+                {
+                    for (int offY = -1; offY <= 1; offY++)
+                    {
+                        auto x = WrapCoordinate(i + offX, height, boundary);
+                        auto y = WrapCoordinate(j + offY, width, boundary);
+                        if ((offX || offY) && x >= 0 && y >= 0 && state[x][y])
+                            nrAliveNeighbors++;
+                    }
+                }
+                next[i][j] = rule.IsAliveNextGeneration(state[i][j], nrAliveNeighbors);
+            }
+        }
+        return next;
+    }
+
+    std::vector<State> ReferenceGenerations(const State& state, const Rule& rule, Boundary boundary)
+    {
+        auto generations = std::vector<State>{ state };
+        for (int generation = 0; generation < Generations; generation++)
+            generations.push_back(ReferenceStep(generations.back(), rule, boundary));
+        return generations;
+    }
+
+    using Check = std::function<void(int width, int height, const Rule& rule, Boundary boundary, const std::vector<State>& expected)>;
+
+    // Runs check for every size, rule and boundary with the reference generations.
+    void ForEachCase(const std::vector<Boundary>& boundaries, const Check& check)
+    {
+        auto seed = 100u;
+        for (auto [width, height] : Sizes)
+        {
+            for (const auto& rule : Rules())
+            {
+                for (auto boundary : boundaries)
+                {
+                    CAPTURE(width);
+                    CAPTURE(height);
+                    CAPTURE(RuleToString(rule));
+                    CAPTURE(BoundaryName(boundary));
+                    auto initial = RandomState(width, height, seed++, 35);
+                    check(width, height, rule, boundary, ReferenceGenerations(initial, rule, boundary));
+                }
+            }
+        }
+    }
+
+    void ForEachCase(const Check& check)
+    {
+        ForEachCase({ Boundary::Dead, Boundary::Torus, Boundary::Mirror }, check);
+    }
+
+    // The unbounded engines are compared on a dead board with room for everything that can
+    // grow in Generations generations.
+    constexpr int Margin = Generations + 1;
+
+    State Padded(const State& state)
+    {
+        auto width = static_cast<int>(state.front().size());
+        auto padded = State(state.size() + 2 * Margin, std::vector<bool>(width + 2 * Margin));
+        for (std::size_t i = 0; i < state.size(); i++)
+        {
+            for (int j = 0; j < width; j++)
+                padded[i + Margin][j + Margin] = state[i][j];
+        }
+        return padded;
+    }
+
+    State Flat(const State_Contiguous& cells, int width, int height)
+    {
+        auto state = State(height, std::vector<bool>(width));
+        for (int i = 0; i < height; i++)
+        {
+            for (int j = 0; j < width; j++)
+                state[i][j] = cells[static_cast<std::size_t>(i) * width + j];
+        }
+        return state;
+    }
+
+    void Setup(GameOfLife_BitPacked& gol, const Rule& rule, Boundary boundary, const State& initial, bool useLookupTable)
+    {
+        gol.SetRule(rule);
+        gol.SetBoundary(boundary);
+        gol.SetUseLookupTable(useLookupTable);
+        gol.SetInitialState(initial);
+    }
+}
+
+TEST_CASE("vector<bool> engine matches the reference")
+{
+    ForEachCase([](int width, int height, const Rule& rule, Boundary boundary, const std::vector<State>& expected)
+    {
+        auto stepped = GameOfLife(width, height);
+        auto changed = GameOfLife(width, height);
+        auto incremental = GameOfLife(width, height);
+        auto regions = GameOfLife(width, height);
+        for (auto* gol : { &stepped, &changed, &incremental, &regions })
+        {
+            gol->SetRule(rule);
+            gol->SetBoundary(boundary);
+            gol->SetInitialState(expected.front());
+        }
+
+        auto changes = incremental.GenNextStateChanges();
+        incremental.DoStateChanges(changes);
+        CHECK(incremental.GetState() == expected[1]);
+        for (int generation = 1; generation <= Generations; generation++)
+        {
+            stepped.Step();
+            changed.DoStateChanges(changed.GenNextStateChanges());
+            if (generation > 1)
+            {
+                changes = incremental.GenNextStateChanges(changes);
+                incremental.DoStateChanges(changes);
+            }
+            // regions split at multiples of the tile size, evaluated before any is applied
+            auto regionChanges = StateChanges();
+            for (const auto& region : PartitionBoard(height, width, 4, PartitionStrategy::Tiles, GameOfLife::TileSize))
+            {
+                auto part = regions.GenNextStateChanges(region);
+                regionChanges.insert(regionChanges.end(), part.begin(), part.end());
+            }
+            regions.DoStateChanges(regionChanges);
+
+            CHECK(stepped.GetState() == expected[generation]);
+            CHECK(changed.GetState() == expected[generation]);
+            CHECK(incremental.GetState() == expected[generation]);
+            CHECK(regions.GetState() == expected[generation]);
+        }
+    });
+}
+
+TEST_CASE("contiguous engine matches the reference")
+{
+    ForEachCase([](int width, int height, const Rule& rule, Boundary boundary, const std::vector<State>& expected)
+    {
+        auto gol = GameOfLife_Contiguous(width, height);
+        gol.SetRule(rule);
+        gol.SetBoundary(boundary);
+        gol.SetInitialState(expected.front());
+        for (int generation = 1; generation <= Generations; generation++)
+        {
+            gol.DoStateChanges(gol.GenNextStateChanges());
+            CHECK(Flat(gol.GetState(), width, height) == expected[generation]);
+        }
+    });
+}
+
+TEST_CASE("bit-packed step matches the reference")
+{
+    auto pool = ThreadPool(4);
+    ForEachCase([&pool](int width, int height, const Rule& rule, Boundary boundary, const std::vector<State>& expected)
+    {
+        for (auto useLookupTable : { false, true })
+        {
+            CAPTURE(useLookupTable);
+            auto serial = GameOfLife_BitPacked(width, height);
+            auto parallel = GameOfLife_BitPacked(width, height);
+            Setup(serial, rule, boundary, expected.front(), useLookupTable);
+            Setup(parallel, rule, boundary, expected.front(), useLookupTable);
+            for (int generation = 1; generation <= Generations; generation++)
+            {
+                auto changes = StateChanges();
+                serial.Step(&changes);
+                parallel.Step(pool);
+                CHECK(serial.GetState() == expected[generation]);
+                CHECK(parallel.GetState() == expected[generation]);
+
+                auto flipped = std::size_t(0);
+                for (int i = 0; i < height; i++)
+                {
+                    for (int j = 0; j < width; j++)
+                        flipped += expected[generation][i][j] != expected[generation - 1][i][j];
+                }
+                CHECK(changes.size() == flipped);
+            }
+        }
+    });
+}
+
+TEST_CASE("bit-packed advance and dataflow match the reference")
+{
+    auto pool = ThreadPool(4);
+    ForEachCase([&pool](int width, int height, const Rule& rule, Boundary boundary, const std::vector<State>& expected)
+    {
+        for (auto useLookupTable : { false, true })
+        {
+            CAPTURE(useLookupTable);
+            for (int depth : { 1, 2, 4 })
+            {
+                CAPTURE(depth);
+                auto serial = GameOfLife_BitPacked(width, height);
+                auto parallel = GameOfLife_BitPacked(width, height);
+                Setup(serial, rule, boundary, expected.front(), useLookupTable);
+                Setup(parallel, rule, boundary, expected.front(), useLookupTable);
+                serial.Advance(Generations, depth);
+                parallel.Advance(pool, 1, depth);
+                parallel.Advance(pool, Generations - 1, depth);
+                CHECK(serial.GetState() == expected.back());
+                CHECK(parallel.GetState() == expected.back());
+            }
+            for (int maxSkew : { 1, 3 })
+            {
+                CAPTURE(maxSkew);
+                auto gol = GameOfLife_BitPacked(width, height);
+                Setup(gol, rule, boundary, expected.front(), useLookupTable);
+                gol.AdvanceDataflow(pool, Generations, maxSkew);
+                CHECK(gol.GetState() == expected.back());
+            }
+        }
+    });
+}
+
+TEST_CASE("bit-packed dataflow matches the reference across tiles")
+{
+    // several 32-row by 16384-column tiles in both directions
+    auto pool = ThreadPool(4);
+    const auto initial = RandomState(16384 + 70, 100, 7, 35);
+    const auto expected = ReferenceGenerations(initial, ConwayLife, Boundary::Dead);
+    for (int maxSkew : { 1, 2, 4 })
+    {
+        CAPTURE(maxSkew);
+        auto gol = GameOfLife_BitPacked(16384 + 70, 100);
+        gol.SetInitialState(initial);
+        gol.AdvanceDataflow(pool, Generations, maxSkew);
+        CHECK(gol.GetState() == expected.back());
+    }
+}
+
+TEST_CASE("unbounded engines match the reference")
+{
+    auto pool = ThreadPool(4);
+    ForEachCase({ Boundary::Dead }, [&pool](int width, int height, const Rule& rule, Boundary, const std::vector<State>& original)
+    {
+        const auto expected = ReferenceGenerations(Padded(original.front()), rule, Boundary::Dead);
+        auto nrRows = height + 2 * Margin;
+        auto nrCols = width + 2 * Margin;
+
+        auto sparse = GameOfLife_Sparse();
+        auto sparseParallel = GameOfLife_Sparse();
+        auto hashLife = GameOfLife_HashLife();
+        auto hashLifeSteps = GameOfLife_HashLife();
+        sparse.SetRule(rule);
+        sparseParallel.SetRule(rule);
+        hashLife.SetRule(rule);
+        hashLifeSteps.SetRule(rule);
+        sparse.SetInitialState(original.front());
+        sparseParallel.SetInitialState(original.front());
+        hashLife.SetInitialState(original.front());
+        hashLifeSteps.SetInitialState(original.front());
+
+        for (int generation = 1; generation <= Generations; generation++)
+        {
+            sparse.Step();
+            sparseParallel.Step(pool);
+            REQUIRE(hashLifeSteps.Advance(1));
+            CHECK(sparse.GetState(-Margin, -Margin, nrRows, nrCols) == expected[generation]);
+            CHECK(sparseParallel.GetState(-Margin, -Margin, nrRows, nrCols) == expected[generation]);
+            CHECK(hashLifeSteps.GetState(-Margin, -Margin, nrRows, nrCols) == expected[generation]);
+        }
+        REQUIRE(hashLife.Advance(Generations));
+        CHECK(hashLife.GetState(-Margin, -Margin, nrRows, nrCols) == expected.back());
+        CHECK(hashLife.Population() == sparse.Population());
+
+        auto advanced = GameOfLife_Sparse();
+        advanced.SetRule(rule);
+        advanced.SetInitialState(original.front());
+        advanced.Advance(Generations);
+        CHECK(advanced.GetState(-Margin, -Margin, nrRows, nrCols) == expected.back());
+    });
+}
+
+TEST_CASE("distributed and streaming engines match the reference")
+{
+    ForEachCase({ Boundary::Dead }, [](int width, int height, const Rule& rule, Boundary, const std::vector<State>& expected)
+    {
+        for (auto transport : { HaloTransport::UnixSocket, HaloTransport::SharedMemory })
+        {
+            CAPTURE(HaloTransportName(transport));
+            auto distributed = GameOfLife_Distributed(width, height, 3, transport);
+            distributed.SetRule(rule);
+            distributed.SetInitialState(expected.front());
+            REQUIRE(distributed.Advance(2));
+            REQUIRE(distributed.Advance(Generations - 2));
+            CHECK(distributed.GetState() == expected.back());
+        }
+
+        auto gol = GameOfLife_BitPacked(width, height);
+        gol.SetInitialState(expected.front());
+        std::ostringstream packed;
+        REQUIRE(gol.WritePackedRows(packed));
+        auto streaming = GameOfLife_Streaming(width, height, 2);
+        streaming.SetRule(rule);
+        for (int generation = 1; generation <= Generations; generation++)
+        {
+            std::istringstream input(packed.str());
+            packed = std::ostringstream();
+            REQUIRE(streaming.Step(input, packed));
+        }
+        std::istringstream result(packed.str());
+        REQUIRE(gol.ReadPackedRows(result));
+        CHECK(gol.GetState() == expected.back());
+    });
+}
@@ -0,0 +1,164 @@
+#include <doctest/doctest.h>
+
+#include <Checkpoint.h>
+#include <FileWriter.h>
+#include "TestFiles.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    constexpr WriteBackend Backends[] = { WriteBackend::IoUring, WriteBackend::Threads };
+
+    std::string RandomBytes(std::size_t size, unsigned seed)
+    {
+        std::mt19937 random(seed);
+        auto bytes = std::string(size, '\0');
+        for (auto& byte : bytes)
+            byte = static_cast<char>(random());
+        return bytes;
+    }
+
+    // Writes data in pieces of the given size and checks the file has exactly data.
+    void CheckWrite(WriteBackend backend, const std::string& data, std::size_t pieceBytes, std::size_t chunkBytes, int queueDepth)
+    {
+        auto file = TempFile("writer.bin");
+        auto writer = FileWriter();
+        REQUIRE(writer.Open(file.Path(), backend, chunkBytes, queueDepth));
+        for (std::size_t offset = 0; offset < data.size(); offset += pieceBytes)
+            REQUIRE(writer.Write(data.data() + offset, std::min(pieceBytes, data.size() - offset)));
+        CHECK(writer.BytesWritten() == data.size());
+        REQUIRE(writer.Close());
+        CHECK(ReadWholeFile(file.Path()) == data);
+    }
+}
+
+TEST_CASE("file writer closes empty files")
+{
+    for (auto backend : Backends)
+    {
+        for (int queueDepth : { 1, 8 })
+            CheckWrite(backend, std::string(), 1, FileWriter::DefaultChunkBytes, queueDepth);
+    }
+}
+
+TEST_CASE("file writer writes sizes that are whole chunks")
+{
+    for (auto backend : Backends)
+    {
+        CheckWrite(backend, RandomBytes(FileWriter::DefaultChunkBytes, 1), FileWriter::DefaultChunkBytes, FileWriter::DefaultChunkBytes, 8);
+        CheckWrite(backend, RandomBytes(3 * 4096, 2), 4096, 4096, 1);
+        CheckWrite(backend, RandomBytes(16 * 4096, 3), 1000, 4096, 3);
+    }
+}
+
+TEST_CASE("file writer writes sizes that are not whole blocks")
+{
+    for (auto backend : Backends)
+    {
+        for (std::size_t size : { 1, 4095, 4097, 100000, 3000001 })
+        {
+            CheckWrite(backend, RandomBytes(size, static_cast<unsigned>(size)), 777, 4096, 2);
+            CheckWrite(backend, RandomBytes(size, static_cast<unsigned>(size)), size, 10000, 8);
+        }
+    }
+}
+
+TEST_CASE("file writer reports the backend and fails on bad paths")
+{
+    auto file = TempFile("backend.bin");
+    auto writer = FileWriter();
+    REQUIRE(writer.Open(file.Path(), WriteBackend::Threads));
+    CHECK(writer.Backend() == WriteBackend::Threads);
+    CHECK(writer.Close());
+    CHECK_FALSE(writer.Close());
+    CHECK_FALSE(writer.Write("x", 1));
+
+    CHECK_FALSE(writer.Open("/nonexistent/file.bin"));
+    CHECK_FALSE(writer.IsOpen());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_CASE("file writer fails instead of hanging when the file cannot grow")
+{
+    // a size limit past the first block makes the first write short and the rest fail
+    auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    auto previousLimit = rlimit();
+    ::getrlimit(RLIMIT_FSIZE, &previousLimit);
+
+    for (auto backend : Backends)
+    {
+        auto file = TempFile("limited.bin");
+        auto writer = FileWriter();
+        REQUIRE(writer.Open(file.Path(), backend, 16384, 2));
+        auto limit = previousLimit;
+        limit.rlim_cur = 3 * 4096;
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+
+        auto data = RandomBytes(100000, 4);
+        auto written = writer.Write(data.data(), data.size());
+        auto closed = writer.Close();
+        ::setrlimit(RLIMIT_FSIZE, &previousLimit);
+
+        CHECK_FALSE(written && closed);
+        CHECK(ReadWholeFile(file.Path()).size() <= 16384);
+    }
+    std::signal(SIGXFSZ, previousHandler);
+}
+#endif
+
+TEST_CASE("file writer stream buffers small writes and passes large ones")
+{
+    for (auto backend : Backends)
+    {
+        auto file = TempFile("stream.txt");
+        auto large = RandomBytes(200000, 5);
+        {
+            auto out = FileWriterStream(file.Path(), backend);
+            REQUIRE(out);
+            out << 'x' << 42 << "abc";
+            out.write(large.data(), static_cast<std::streamsize>(large.size()));
+            out << "end";
+            REQUIRE(out.Close());
+        }
+        CHECK(ReadWholeFile(file.Path()) == "x42abc" + large + "end");
+    }
+
+    auto failed = FileWriterStream("/nonexistent/stream.txt");
+    CHECK_FALSE(failed);
+}
+
+TEST_CASE("checkpoints and frame dumps written through the stream match the stream formats")
+{
+    auto gol = GameOfLife_BitPacked(300, 200);
+    gol.SetInitialState(RandomState(300, 200, 13));
+
+    auto checkpointFile = TempFile("stream.ckpt");
+    {
+        auto out = FileWriterStream(checkpointFile.Path());
+        REQUIRE(WriteCheckpoint(out, gol, 9));
+        REQUIRE(out.Close());
+    }
+    std::ostringstream checkpoint;
+    REQUIRE(WriteCheckpoint(checkpoint, gol, 9));
+    CHECK(ReadWholeFile(checkpointFile.Path()) == checkpoint.str());
+
+    auto frameFile = TempFile("frames.txt");
+    {
+        auto out = FileWriterStream(frameFile.Path());
+        REQUIRE(gol.WriteBoardState(out));
+        REQUIRE(out.Close());
+    }
+    std::ostringstream frame;
+    for (const auto& row : gol.GetState())
+    {
+        for (auto alive : row)
+            frame << alive;
+        frame << "\n";
+    }
+    frame << "------------------------------------------\n";
+    CHECK(ReadWholeFile(frameFile.Path()) == frame.str());
+}
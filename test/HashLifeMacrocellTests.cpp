@@ -0,0 +1,100 @@
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <ImplGameOfLife_BitPacked.h>
+#include <ImplGameOfLife_HashLife.h>
+#include "TestFiles.h"
+
+namespace
+{
+    bool ReadText(GameOfLife_HashLife& life, const std::string& text)
+    {
+        std::istringstream in(text);
+        return life.ReadMacrocell(in);
+    }
+}
+
+TEST_CASE("macrocell round trips the universe, rule and generation")
+{
+    auto life = GameOfLife_HashLife();
+    life.SetInitialState(RandomState(100, 60, 4));
+    life.SetRule(HighLife);
+    life.Advance(100);
+
+    std::ostringstream out;
+    REQUIRE(life.WriteMacrocell(out));
+    auto loaded = GameOfLife_HashLife();
+    REQUIRE(ReadText(loaded, out.str()));
+    CHECK(loaded.GetRule() == HighLife);
+    CHECK(loaded.Generation() == 100);
+    CHECK(loaded.Population() == life.Population());
+    CHECK(loaded.GetState(-200, -200, 500, 500) == life.GetState(-200, -200, 500, 500));
+}
+
+TEST_CASE("macrocell regions rasterize into a bit-packed board")
+{
+    auto life = GameOfLife_HashLife();
+    life.SetInitialState(RandomState(130, 70, 5));
+    life.Advance(10);
+
+    auto gol = GameOfLife_BitPacked(150, 90);
+    life.RasterizeRegion(gol, -10, -5);
+    CHECK(gol.GetState() == life.GetState(-10, -5, 90, 150));
+}
+
+TEST_CASE("macrocell reads a hand written glider")
+{
+    auto life = GameOfLife_HashLife();
+    REQUIRE(ReadText(life, "[M2] (golly 4.0)\n#R B3/S23\n.*$..*$***$\n4 0 0 0 1\n"));
+    CHECK(life.Population() == 5);
+    CHECK(life.GetCell(0, 1));
+    CHECK(life.GetCell(2, 2));
+}
+
+TEST_CASE("macrocell rejects malformed files")
+{
+    auto life = GameOfLife_HashLife();
+    CHECK_FALSE(ReadText(life, ""));
+    CHECK_FALSE(ReadText(life, "x = 3, y = 3\n"));
+    // a child that does not exist yet
+    CHECK_FALSE(ReadText(life, "[M2]\n*$\n4 0 0 0 2\n"));
+    // a child of the wrong level
+    CHECK_FALSE(ReadText(life, "[M2]\n*$\n4 0 0 0 1\n6 0 0 0 2\n"));
+    CHECK_FALSE(ReadText(life, "[M2]\n*$\n3 0 0 0 1\n"));
+    CHECK_FALSE(ReadText(life, "[M2]\n*$\n63 0 0 0 0\n"));
+    CHECK_FALSE(ReadText(life, "[M2]\n*$\n4 0 0 0\n"));
+    CHECK_FALSE(ReadText(life, "[M2]\n*********$\n"));
+    CHECK_FALSE(ReadText(life, "[M2]\n*$*$*$*$*$*$*$*$*$\n"));
+    CHECK_FALSE(ReadText(life, "[M2]\n#R B9/S23\n"));
+}
+
+TEST_CASE("macrocell of the deepest root round trips and rasterizes")
+{
+    auto life = GameOfLife_HashLife();
+    life.SetInitialState(std::vector<std::pair<int, int>>{ { 0, 1 }, { 1, 2 }, { 2, 0 }, { 2, 1 }, { 2, 2 } });
+    CHECK_FALSE(life.Advance(std::uint64_t(1) << 61));
+    for (int jump = 0; jump < 4; jump++)
+        REQUIRE(life.Advance(std::uint64_t(1) << 59));
+
+    std::ostringstream out;
+    REQUIRE(life.WriteMacrocell(out));
+    auto loaded = GameOfLife_HashLife();
+    REQUIRE(ReadText(loaded, out.str()));
+    CHECK(loaded.Population() == 5);
+    CHECK(loaded.Generation() == std::uint64_t(1) << 61);
+
+    // the glider moved 2^59 cells down and right
+    const auto offset = std::int64_t(1) << 59;
+    auto gol = GameOfLife_BitPacked(70, 20);
+    REQUIRE(loaded.RasterizeRegion(gol, offset - 5, offset - 30));
+    CHECK(gol.Population() == 5);
+    CHECK(gol.GetState() == life.GetState(offset - 5, offset - 30, 20, 70));
+
+    // regions far beyond the root are empty
+    gol.SetInitialState(RandomState(70, 20, 6));
+    REQUIRE(loaded.RasterizeRegion(gol, INT64_MAX - 5, INT64_MIN));
+    CHECK(gol.Population() == 0);
+    gol.SetInitialState(RandomState(70, 20, 7));
+    REQUIRE(loaded.RasterizeRegion(gol, INT64_MIN, INT64_MAX));
+    CHECK(gol.Population() == 0);
+}
@@ -0,0 +1,54 @@
+#include <doctest/doctest.h>
+
+#include <ImplGameOfLife_HashLife.h>
+
+namespace
+{
+    void SetGlider(GameOfLife_HashLife& life)
+    {
+        life.SetInitialState(std::vector<std::pair<int, int>>{ { 0, 1 }, { 1, 2 }, { 2, 0 }, { 2, 1 }, { 2, 2 } });
+    }
+}
+
+TEST_CASE("hashlife jumps a glider as far as the root allows")
+{
+    auto life = GameOfLife_HashLife();
+    SetGlider(life);
+    const auto glider = life.GetState(0, 0, 3, 3);
+
+    // a glider moves one cell down and right every 4 generations
+    REQUIRE(life.Advance(std::uint64_t(1) << 59));
+    CHECK(life.Generation() == std::uint64_t(1) << 59);
+    CHECK(life.Population() == 5);
+    const auto offset = std::int64_t(1) << 57;
+    CHECK(life.GetState(offset, offset, 3, 3) == glider);
+}
+
+TEST_CASE("hashlife refuses jumps past the deepest root")
+{
+    auto life = GameOfLife_HashLife();
+    SetGlider(life);
+    CHECK_FALSE(life.Advance(std::uint64_t(1) << 60));
+    CHECK(life.Generation() == 0);
+    CHECK(life.Population() == 5);
+
+    // every jump of 2^59 carries the glider 2^57 cells, and a jump has to start within 2^59 of
+    // the origin
+    for (int jump = 0; jump < 4; jump++)
+        REQUIRE(life.Advance(std::uint64_t(1) << 59));
+    CHECK_FALSE(life.Advance(std::uint64_t(1) << 59));
+    CHECK(life.Generation() == std::uint64_t(1) << 61);
+    CHECK(life.Population() == 5);
+}
+
+TEST_CASE("hashlife cells beyond the deepest root are refused")
+{
+    auto life = GameOfLife_HashLife();
+    const auto limit = std::int64_t(1) << (GameOfLife_HashLife::MaxLevel - 1);
+    CHECK(life.SetCell(limit - 1, -limit, true));
+    CHECK(life.GetCell(limit - 1, -limit));
+    CHECK_FALSE(life.SetCell(limit, 0, true));
+    CHECK_FALSE(life.SetCell(0, INT64_MIN, true));
+    CHECK_FALSE(life.GetCell(INT64_MIN, INT64_MAX));
+    CHECK(life.Population() == 1);
+}
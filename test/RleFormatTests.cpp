@@ -0,0 +1,72 @@
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <RleFormat.h>
+#include "TestFiles.h"
+
+namespace
+{
+    bool ReadPattern(const std::string& text, GameOfLife_BitPacked& gol)
+    {
+        std::istringstream in(text);
+        auto header = RleHeader();
+        return ReadRleHeader(in, header) && ReadRleCells(in, gol);
+    }
+}
+
+TEST_CASE("rle round trips a random board")
+{
+    auto gol = GameOfLife_BitPacked(200, 90);
+    gol.SetInitialState(RandomState(200, 90, 3));
+    gol.SetRule(HighLife);
+    std::ostringstream out;
+    REQUIRE(WriteRle(out, gol));
+
+    std::istringstream in(out.str());
+    auto header = RleHeader();
+    REQUIRE(ReadRleHeader(in, header));
+    CHECK(header.width == 200);
+    CHECK(header.height == 90);
+    CHECK(header.hasRule);
+    CHECK(header.rule == HighLife);
+    auto loaded = GameOfLife_BitPacked(header.width, header.height);
+    REQUIRE(ReadRleCells(in, loaded));
+    CHECK(loaded.GetState() == gol.GetState());
+}
+
+TEST_CASE("rle reads a glider with comments and a bounded grid rule")
+{
+    auto gol = GameOfLife_BitPacked(3, 3);
+    REQUIRE(ReadPattern("#N Glider\n#C comment\nx = 3, y = 3, rule = B3/S23:T10,10\nbo$2bo$3o!\n", gol));
+    CHECK(gol.GetState() == State{ { false, true, false }, { false, false, true }, { true, true, true } });
+}
+
+TEST_CASE("rle multi-state cells are alive, prefixed states are one cell")
+{
+    auto gol = GameOfLife_BitPacked(4, 1);
+    REQUIRE(ReadPattern("x = 4, y = 1\nA.pBC!\n", gol));
+    CHECK(gol.GetState() == State{ { true, false, true, true } });
+    auto exact = GameOfLife_BitPacked(3, 1);
+    REQUIRE(ReadPattern("x = 3, y = 1\nApBC!\n", exact));
+    CHECK(exact.GetState() == State{ { true, true, true } });
+}
+
+TEST_CASE("rle rejects malformed or oversized patterns")
+{
+    auto gol = GameOfLife_BitPacked(3, 3);
+    CHECK_FALSE(ReadPattern("x = 3, y = 3\n999999999$999999999$999999999$o!\n", gol));
+    CHECK_FALSE(ReadPattern("x = 3, y = 3\n99999999999999o!\n", gol));
+    CHECK_FALSE(ReadPattern("x = 3, y = 3\n999999999b999999999b999999999bo!\n", gol));
+    CHECK_FALSE(ReadPattern("x = 3, y = 3\n4o!\n", gol));
+    CHECK_FALSE(ReadPattern("x = 3, y = 3\n3$o!\n", gol));
+    CHECK_FALSE(ReadPattern("x = 3, y = 3\nbz!\n", gol));
+    CHECK_FALSE(ReadPattern("x = 3, y = 3\npo!\n", gol));
+    CHECK_FALSE(ReadPattern("y = 3\no!\n", gol));
+    CHECK_FALSE(ReadPattern("x = 3, y = 99999999999\no!\n", gol));
+    CHECK_FALSE(ReadPattern("", gol));
+
+    std::istringstream in("o!");
+    CHECK_FALSE(ReadRleCells(in, gol, -1, 0));
+    std::istringstream outside("o!");
+    CHECK_FALSE(ReadRleCells(outside, gol, 3, 0));
+}
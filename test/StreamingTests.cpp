@@ -0,0 +1,108 @@
+#include <doctest/doctest.h>
+
+#include <sstream>
+#include <ImplGameOfLife_BitPacked.h>
+#include <ImplGameOfLife_Streaming.h>
+#include "TestFiles.h"
+
+namespace
+{
+    void WritePackedFile(const GameOfLife_BitPacked& gol, const std::string& path)
+    {
+        std::ofstream out(path, std::ios::binary);
+        REQUIRE(gol.WritePackedRows(out));
+    }
+
+    void ReadPackedFile(GameOfLife_BitPacked& gol, const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        REQUIRE(gol.ReadPackedRows(in));
+    }
+}
+
+TEST_CASE("streaming step matches the bit-packed engine")
+{
+    auto gol = GameOfLife_BitPacked(150, 40);
+    gol.SetInitialState(RandomState(150, 40, 14));
+    std::ostringstream packed;
+    REQUIRE(gol.WritePackedRows(packed));
+
+    auto streaming = GameOfLife_Streaming(150, 40, 4);
+    std::istringstream input(packed.str());
+    std::ostringstream output;
+    REQUIRE(streaming.Step(input, output));
+    gol.Step();
+
+    auto stepped = GameOfLife_BitPacked(150, 40);
+    std::istringstream result(output.str());
+    REQUIRE(stepped.ReadPackedRows(result));
+    CHECK(stepped.GetState() == gol.GetState());
+    CHECK(streaming.Population() == gol.Population());
+}
+
+TEST_CASE("streaming step fails on truncated input")
+{
+    auto gol = GameOfLife_BitPacked(100, 20);
+    std::ostringstream packed;
+    REQUIRE(gol.WritePackedRows(packed));
+
+    auto streaming = GameOfLife_Streaming(100, 20);
+    std::istringstream input(packed.str().substr(0, packed.str().size() - 1));
+    std::ostringstream output;
+    CHECK_FALSE(streaming.Step(input, output));
+}
+
+TEST_CASE("streaming advance between files, output of whole writer chunks")
+{
+    // 8192 rows of 16 words are exactly one 1 MiB writer chunk per generation
+    auto gol = GameOfLife_BitPacked(1024, 8192);
+    gol.SetInitialState(RandomState(1024, 8192, 15));
+    auto input = TempFile("streaming-in.bin");
+    auto output = TempFile("streaming-out.bin");
+    WritePackedFile(gol, input.Path());
+
+    auto streaming = GameOfLife_Streaming(1024, 8192);
+    REQUIRE(streaming.Advance(input.Path(), output.Path(), 3));
+    for (int generation = 0; generation < 3; generation++)
+        gol.Step();
+
+    auto advanced = GameOfLife_BitPacked(1024, 8192);
+    ReadPackedFile(advanced, output.Path());
+    CHECK(advanced.GetState() == gol.GetState());
+    CHECK_FALSE(std::filesystem::exists(output.Path() + ".tmp"));
+    CHECK_FALSE(streaming.Advance(input.Path(), input.Path(), 1));
+}
+
+TEST_CASE("streaming advance refuses to overwrite its input")
+{
+    auto gol = GameOfLife_BitPacked(100, 20);
+    gol.SetInitialState(RandomState(100, 20, 16));
+    auto output = TempFile("streaming-same.bin");
+    auto input = TempFile("streaming-same.bin.tmp");
+    auto link = TempFile("streaming-link.bin");
+    WritePackedFile(gol, input.Path());
+    const auto original = ReadWholeFile(input.Path());
+
+    auto streaming = GameOfLife_Streaming(100, 20);
+    CHECK_FALSE(streaming.Advance(input.Path(), output.Path(), 2));
+    std::filesystem::create_hard_link(input.Path(), link.Path());
+    CHECK_FALSE(streaming.Advance(input.Path(), link.Path(), 1));
+    auto spelled = (std::filesystem::path(input.Path()).parent_path() / "." / std::filesystem::path(input.Path()).filename()).string();
+    CHECK_FALSE(streaming.Advance(input.Path(), spelled, 1));
+    CHECK(ReadWholeFile(input.Path()) == original);
+}
+
+TEST_CASE("streaming advance removes the temporary file when it fails")
+{
+    auto gol = GameOfLife_BitPacked(100, 20);
+    std::ostringstream packed;
+    REQUIRE(gol.WritePackedRows(packed));
+    auto input = TempFile("streaming-truncated.bin");
+    auto output = TempFile("streaming-failed.bin");
+    WriteWholeFile(input.Path(), packed.str().substr(0, packed.str().size() / 2));
+
+    // with two generations the first one goes to the temporary file
+    auto streaming = GameOfLife_Streaming(100, 20);
+    CHECK_FALSE(streaming.Advance(input.Path(), output.Path(), 2));
+    CHECK_FALSE(std::filesystem::exists(output.Path() + ".tmp"));
+}
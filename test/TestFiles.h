@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// File in the temp directory that is removed with the object.
+class TempFile
+{
+public:
+    explicit TempFile(const std::string& name) :
+        m_path((std::filesystem::temp_directory_path() / ("gameoflife-test-" + name)).string())
+    {
+        std::filesystem::remove(m_path);
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+    ~TempFile()
+    {
+        std::error_code error;
+        std::filesystem::remove(m_path, error);
+        std::filesystem::remove(m_path + ".tmp", error);
+    }
+
+    const std::string& Path() const
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+};
+
+inline std::string ReadWholeFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+inline void WriteWholeFile(const std::string& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// Overwrites a little-endian field in place, to corrupt headers.
+template <typename T>
+void PatchFile(const std::string& path, std::streamoff offset, T value)
+{
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline std::vector<std::vector<bool>> RandomState(int width, int height, unsigned seed, int percentAlive = 30)
+{
+    std::mt19937 random(seed);
+    auto state = std::vector<std::vector<bool>>(height, std::vector<bool>(width));
+    for (auto& row : state)
+        for (int j = 0; j < width; j++)
+            row[j] = static_cast<int>(random() % 100) < percentAlive;
+    return state;
+}